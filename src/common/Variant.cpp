@@ -41,6 +41,164 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
+template <typename T>
+static void writeValue(std::vector<char> &buffer, const T &value)
+{
+	size_t offset = buffer.size();
+	buffer.resize(offset + sizeof(T));
+	memcpy(&buffer[offset], &value, sizeof(T));
+}
+
+template <typename T>
+static T readValue(const char *&p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	p += sizeof(T);
+	return value;
+}
+
+static bool serializeTable(lua_State *L, int idx, Variant::SharedTable *table, std::vector<const void *> &parents);
+
+// Appends the value at the given stack index to the table's buffer. Returns
+// false if the value can't be stored in a Variant.
+static bool serializeValue(lua_State *L, int idx, Variant::SharedTable *table, std::vector<const void *> &parents)
+{
+	std::vector<char> &buffer = table->buffer;
+	size_t len;
+	const char *str;
+	Proxy *p = nullptr;
+
+	switch (lua_type(L, idx))
+	{
+	case LUA_TBOOLEAN:
+		buffer.push_back((char) Variant::BOOLEAN);
+		buffer.push_back((char) luax_toboolean(L, idx));
+		return true;
+	case LUA_TNUMBER:
+		buffer.push_back((char) Variant::NUMBER);
+		writeValue(buffer, (double) lua_tonumber(L, idx));
+		return true;
+	case LUA_TSTRING:
+		str = lua_tolstring(L, idx, &len);
+		buffer.push_back((char) Variant::STRING);
+		writeValue(buffer, len);
+		buffer.insert(buffer.end(), str, str + len);
+		return true;
+	case LUA_TLIGHTUSERDATA:
+		buffer.push_back((char) Variant::LUSERDATA);
+		writeValue(buffer, lua_touserdata(L, idx));
+		return true;
+	case LUA_TUSERDATA:
+		p = tryextractproxy(L, idx);
+		if (p == nullptr)
+		{
+			luax_typerror(L, idx, "love type");
+			return false;
+		}
+		buffer.push_back((char) Variant::LOVEOBJECT);
+		p->object->retain();
+		table->objects.push_back(*p);
+		return true;
+	case LUA_TTABLE:
+		return serializeTable(L, idx, table, parents);
+	default:
+		return false;
+	}
+}
+
+static bool serializeTable(lua_State *L, int idx, Variant::SharedTable *table, std::vector<const void *> &parents)
+{
+	if (idx < 0) // Fix the stack position, lua_next modifies it.
+		idx += lua_gettop(L) + 1;
+
+	// Make sure this table isn't already being serialized further up.
+	const void *tablePointer = lua_topointer(L, idx);
+	if (std::find(parents.begin(), parents.end(), tablePointer) != parents.end())
+		throw love::Exception("Cycle detected in table");
+
+	parents.push_back(tablePointer);
+
+	std::vector<char> &buffer = table->buffer;
+	buffer.push_back((char) Variant::TABLE);
+
+	// The array size is a hint for lua_createtable. The pair count is filled
+	// in once we know it.
+	writeValue(buffer, (uint32) luax_objlen(L, idx));
+	size_t countOffset = buffer.size();
+	writeValue(buffer, (uint32) 0);
+
+	uint32 count = 0;
+	lua_pushnil(L);
+
+	while (lua_next(L, idx))
+	{
+		if (!serializeValue(L, -2, table, parents) || !serializeValue(L, -1, table, parents))
+		{
+			lua_pop(L, 2);
+			parents.pop_back();
+			return false;
+		}
+
+		lua_pop(L, 1);
+		count++;
+	}
+
+	memcpy(&buffer[countOffset], &count, sizeof(uint32));
+
+	parents.pop_back();
+	return true;
+}
+
+// Pushes the value at p onto the stack and advances p past it.
+static void deserializeValue(lua_State *L, const char *&p, const Proxy *&objects)
+{
+	Variant::Type type = (Variant::Type) *p++;
+
+	switch (type)
+	{
+	case Variant::BOOLEAN:
+		lua_pushboolean(L, *p++ != 0);
+		break;
+	case Variant::NUMBER:
+		lua_pushnumber(L, readValue<double>(p));
+		break;
+	case Variant::STRING:
+	{
+		size_t len = readValue<size_t>(p);
+		lua_pushlstring(L, p, len);
+		p += len;
+		break;
+	}
+	case Variant::LUSERDATA:
+		lua_pushlightuserdata(L, readValue<void *>(p));
+		break;
+	case Variant::LOVEOBJECT:
+		luax_pushtype(L, *objects->type, objects->object);
+		objects++;
+		break;
+	case Variant::TABLE:
+	{
+		uint32 arraysize = readValue<uint32>(p);
+		uint32 count = readValue<uint32>(p);
+		arraysize = std::min(arraysize, count);
+
+		lua_createtable(L, (int) arraysize, (int) (count - arraysize));
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			deserializeValue(L, p, objects);
+			deserializeValue(L, p, objects);
+			lua_rawset(L, -3);
+		}
+		break;
+	}
+	default:
+		lua_pushnil(L);
+		break;
+	}
+}
+
 Variant::Variant()
 	: type(NIL)
 {
@@ -94,11 +252,11 @@ Variant::Variant(love::Type *lovetype, love::Object *object)
 		data.objectproxy.object->retain();
 }
 
-// Variant gets ownership of the vector.
-Variant::Variant(std::vector<std::pair<Variant, Variant>> *table)
+Variant::Variant(SharedTable *table)
 	: type(TABLE)
 {
-	data.table = new SharedTable(table);
+	data.table = table;
+	data.table->retain();
 }
 
 Variant::Variant(const Variant &v)
@@ -152,7 +310,7 @@ Variant &Variant::operator = (const Variant &v)
 	return *this;
 }
 
-Variant Variant::fromLua(lua_State *L, int n, std::set<const void*> *tableSet)
+Variant Variant::fromLua(lua_State *L, int n)
 {
 	size_t len;
 	const char *str;
@@ -185,49 +343,11 @@ Variant Variant::fromLua(lua_State *L, int n, std::set<const void*> *tableSet)
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
-			std::set<const void *> topTableSet;
-			std::vector<std::pair<Variant, Variant>> *table = new std::vector<std::pair<Variant, Variant>>();
-
-			// We can use a pointer to a stack-allocated variable because it's
-			// never used after the stack-allocated variable is destroyed.
-			if (tableSet == nullptr)
-				tableSet = &topTableSet;
-
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
-			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
-			}
-
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->reserve(len);
-
-			lua_pushnil(L);
-
-			while (lua_next(L, n))
-			{
-				table->emplace_back(fromLua(L, -2, tableSet), fromLua(L, -1, tableSet));
-				lua_pop(L, 1);
-
-				const auto &p = table->back();
-				if (p.first.getType() == UNKNOWN || p.second.getType() == UNKNOWN)
-				{
-					success = false;
-					break;
-				}
-			}
-
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
-
-			if (success)
-				return Variant(table);
-			else
-				delete table;
+			std::vector<const void *> parents;
+			StrongRef<SharedTable> table(new SharedTable(), Acquire::NORETAIN);
+
+			if (serializeTable(L, n, table, parents))
+				return Variant(table.get());
 		}
 		break;
 	}
@@ -261,19 +381,9 @@ void Variant::toLua(lua_State *L) const
 		break;
 	case TABLE:
 	{
-		std::vector<std::pair<Variant, Variant>> *table = data.table->table;
-		int tsize = (int) table->size();
-
-		lua_createtable(L, 0, tsize);
-
-		for (int i = 0; i < tsize; ++i)
-		{
-			std::pair<Variant, Variant> &kv = (*table)[i];
-			kv.first.toLua(L);
-			kv.second.toLua(L);
-			lua_settable(L, -3);
-		}
-
+		const char *p = data.table->buffer.data();
+		const Proxy *objects = data.table->objects.data();
+		deserializeValue(L, p, objects);
 		break;
 	}
 	case NIL:
@@ -283,4 +393,18 @@ void Variant::toLua(lua_State *L) const
 	}
 }
 
+void Variant::toLuaView(lua_State *L) const
+{
+	if (type == STRING)
+		luax_pushtype(L, love::Data::type, data.string);
+	else if (type == SMALLSTRING)
+	{
+		SharedString *str = new SharedString(data.smallstring.str, data.smallstring.len);
+		luax_pushtype(L, love::Data::type, str);
+		str->release();
+	}
+	else
+		toLua(L);
+}
+
 } // love
@@ -23,12 +23,12 @@
 
 #include "common/runtime.h"
 #include "common/Object.h"
+#include "common/Data.h"
 #include "common/int.h"
 
 #include <cstring>
 #include <string>
 #include <vector>
-#include <set>
 
 namespace love
 {
@@ -52,7 +52,9 @@ class Variant
 		TABLE
 	};
 
-	class SharedString : public love::Object
+	// Also a Data, so large strings can be handed to another Lua state by
+	// reference instead of being copied into it.
+	class SharedString : public love::Data
 	{
 	public:
 
@@ -65,22 +67,32 @@ class Variant
 		}
 		virtual ~SharedString() { delete[] str; }
 
+		// Implements Data.
+		SharedString *clone() const override { return new SharedString(str, len); }
+		void *getData() const override { return str; }
+		size_t getSize() const override { return len; }
+
 		char *str;
 		size_t len;
 	};
 
+	// Tables (including nested ones) are flattened into a single buffer of
+	// type-tagged values, which toLua walks to rebuild the Lua table. Love
+	// objects in the table are kept in a separate list so they stay retained.
 	class SharedTable : public love::Object
 	{
 	public:
 
-		SharedTable(std::vector<std::pair<Variant, Variant>> *table)
-			: table(table)
+		SharedTable() {}
+
+		virtual ~SharedTable()
 		{
+			for (const Proxy &p : objects)
+				p.object->release();
 		}
 
-		virtual ~SharedTable() { delete table; }
-
-		std::vector<std::pair<Variant, Variant>> *table;
+		std::vector<char> buffer;
+		std::vector<Proxy> objects;
 	};
 
 	union Data
@@ -105,7 +117,7 @@ class Variant
 	Variant(const std::string &str);
 	Variant(void *lightuserdata);
 	Variant(love::Type *type, love::Object *object);
-	Variant(std::vector<std::pair<Variant, Variant>> *table);
+	Variant(SharedTable *table);
 	Variant(const Variant &v);
 	Variant(Variant &&v);
 	~Variant();
@@ -115,9 +127,15 @@ class Variant
 	Type getType() const { return type; }
 	const Data &getData() const { return data; }
 
-	static Variant fromLua(lua_State *L, int n, std::set<const void*> *tableSet = nullptr);
+	static Variant fromLua(lua_State *L, int n);
 	void toLua(lua_State *L) const;
 
+	/**
+	 * Like toLua, but strings are pushed as Data objects which reference the
+	 * Variant's memory rather than as Lua strings.
+	 **/
+	void toLuaView(lua_State *L) const;
+
 private:
 
 	Type type;
@@ -168,10 +168,53 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+
+	m_staticBodies = NULL;
+	m_staticBodyCount = 0;
+	m_impulses = NULL;
+	m_borrowed = false;
+	m_asleep = false;
+}
+
+b2Island::b2Island(
+	b2Body** bodies, int32 bodyCount,
+	b2Body** staticBodies, int32 staticBodyCount,
+	b2Contact** contacts, int32 contactCount,
+	b2Joint** joints, int32 jointCount,
+	b2Position* positions, b2Velocity* velocities,
+	b2StackAllocator* allocator, b2ContactImpulse* impulses)
+{
+	m_bodyCapacity = bodyCount;
+	m_contactCapacity = contactCount;
+	m_jointCapacity = jointCount;
+	m_bodyCount = bodyCount;
+	m_contactCount = contactCount;
+	m_jointCount = jointCount;
+
+	m_allocator = allocator;
+	m_listener = NULL;
+
+	m_bodies = bodies;
+	m_contacts = contacts;
+	m_joints = joints;
+
+	m_velocities = velocities;
+	m_positions = positions;
+
+	m_staticBodies = staticBodies;
+	m_staticBodyCount = staticBodyCount;
+	m_impulses = impulses;
+	m_borrowed = true;
+	m_asleep = false;
 }
 
 b2Island::~b2Island()
 {
+	if (m_borrowed)
+	{
+		return;
+	}
+
 	// Warning: the order should reverse the constructor order.
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
@@ -223,6 +266,18 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		m_velocities[i].w = w;
 	}
 
+	// Shared static bodies don't move, so their state is only read.
+	for (int32 i = 0; i < m_staticBodyCount; ++i)
+	{
+		b2Body* b = m_staticBodies[i];
+		int32 index = b->m_islandIndex;
+
+		m_positions[index].c = b->m_sweep.c;
+		m_positions[index].a = b->m_sweep.a;
+		m_velocities[index].v = b->m_linearVelocity;
+		m_velocities[index].w = b->m_angularVelocity;
+	}
+
 	timer.Reset();
 
 	// Solver data
@@ -372,10 +427,18 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 		if (minSleepTime >= b2_timeToSleep && positionSolved)
 		{
-			for (int32 i = 0; i < m_bodyCount; ++i)
+			if (m_borrowed)
+			{
+				// The world puts the bodies to sleep once events are reported.
+				m_asleep = true;
+			}
+			else
 			{
-				b2Body* b = m_bodies[i];
-				b->SetAwake(false);
+				for (int32 i = 0; i < m_bodyCount; ++i)
+				{
+					b2Body* b = m_bodies[i];
+					b->SetAwake(false);
+				}
 			}
 		}
 	}
@@ -515,7 +578,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
-	if (m_listener == NULL)
+	if (m_listener == NULL && m_impulses == NULL)
 	{
 		return;
 	}
@@ -534,6 +597,13 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 			impulse.tangentImpulses[j] = vc->points[j].tangentImpulse;
 		}
 
-		m_listener->PostSolve(c, &impulse);
+		if (m_impulses != NULL)
+		{
+			m_impulses[i] = impulse;
+		}
+		else
+		{
+			m_listener->PostSolve(c, &impulse);
+		}
 	}
 }
@@ -28,6 +28,7 @@ class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
 
 /// This is an internal class.
@@ -36,6 +37,20 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+
+	/// Creates an island which is solved in parallel with other islands. The
+	/// lists are borrowed, not allocated. Static bodies can be shared with other
+	/// islands, so they are kept out of the body list: their state lives at
+	/// their m_islandIndex in the given arrays and is never written back.
+	/// Post-solve impulses are stored in impulses instead of being reported,
+	/// and bodies are not put to sleep; m_asleep is set instead.
+	b2Island(b2Body** bodies, int32 bodyCount,
+			b2Body** staticBodies, int32 staticBodyCount,
+			b2Contact** contacts, int32 contactCount,
+			b2Joint** joints, int32 jointCount,
+			b2Position* positions, b2Velocity* velocities,
+			b2StackAllocator* allocator, b2ContactImpulse* impulses);
+
 	~b2Island();
 
 	void Clear()
@@ -81,6 +96,13 @@ class b2Island
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 
+	b2Body** m_staticBodies;
+	int32 m_staticBodyCount;
+
+	b2ContactImpulse* m_impulses;
+	bool m_borrowed;
+	bool m_asleep;
+
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
@@ -34,10 +34,154 @@
 #include <Box2D/Common/b2Timer.h>
 #include <new>
 
+// Islands recorded by b2World::Solve to be solved in parallel.
+struct b2IslandRecord
+{
+	int32 bodyIndex, bodyCount;
+	int32 staticBodyIndex, staticBodyCount;
+	int32 contactIndex, contactCount;
+	int32 jointIndex, jointCount;
+	bool asleep;
+};
+
+struct b2IslandList
+{
+	b2IslandRecord* islands;
+	int32 islandCount;
+
+	b2Body** bodies;
+	int32 bodyCount;
+
+	// A static body appears once for every island it touches.
+	b2Body** staticBodies;
+	int32 staticBodyCount;
+
+	b2Contact** contacts;
+	b2ContactImpulse* impulses;
+	int32 contactCount;
+
+	b2Joint** joints;
+	int32 jointCount;
+
+	int32 maxIslandBodyCount;
+
+	void Add(const b2Island& island)
+	{
+		b2IslandRecord* r = islands + islandCount++;
+		r->bodyIndex = bodyCount;
+		r->staticBodyIndex = staticBodyCount;
+		r->contactIndex = contactCount;
+		r->jointIndex = jointCount;
+		r->asleep = false;
+
+		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		{
+			b2Body* b = island.m_bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				staticBodies[staticBodyCount++] = b;
+			}
+			else
+			{
+				bodies[bodyCount++] = b;
+			}
+		}
+
+		for (int32 i = 0; i < island.m_contactCount; ++i)
+		{
+			contacts[contactCount++] = island.m_contacts[i];
+		}
+
+		for (int32 i = 0; i < island.m_jointCount; ++i)
+		{
+			joints[jointCount++] = island.m_joints[i];
+		}
+
+		r->bodyCount = bodyCount - r->bodyIndex;
+		r->staticBodyCount = staticBodyCount - r->staticBodyIndex;
+		r->contactCount = contactCount - r->contactIndex;
+		r->jointCount = jointCount - r->jointIndex;
+
+		maxIslandBodyCount = b2Max(maxIslandBodyCount, r->bodyCount);
+	}
+};
+
+class b2IslandSolveTask : public b2Task
+{
+public:
+	b2IslandSolveTask(b2IslandList* list, int32 stateCapacity, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
+		: m_list(list)
+		, m_stateCapacity(stateCapacity)
+		, m_step(step)
+		, m_gravity(gravity)
+		, m_allowSleep(allowSleep)
+	{
+	}
+
+	void Run(int32 begin, int32 end)
+	{
+		// Each range gets its own allocator and state arrays, which are reused
+		// by all of its islands.
+		b2IslandSolveScratch scratch(m_stateCapacity);
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2IslandRecord* r = m_list->islands + i;
+
+			b2Island island(m_list->bodies + r->bodyIndex, r->bodyCount,
+							m_list->staticBodies + r->staticBodyIndex, r->staticBodyCount,
+							m_list->contacts + r->contactIndex, r->contactCount,
+							m_list->joints + r->jointIndex, r->jointCount,
+							scratch.positions, scratch.velocities, scratch.allocator,
+							m_list->impulses + r->contactIndex);
+
+			b2Profile profile;
+			island.Solve(&profile, m_step, m_gravity, m_allowSleep);
+
+			r->asleep = island.m_asleep;
+		}
+	}
+
+private:
+	// Freed by the destructor, since b2Assert can throw out of Solve. The
+	// allocator is too big to keep on a worker thread's stack.
+	struct b2IslandSolveScratch
+	{
+		b2IslandSolveScratch(int32 stateCapacity)
+		{
+			void* mem = b2Alloc(sizeof(b2StackAllocator));
+			allocator = new (mem) b2StackAllocator;
+
+			positions = (b2Position*)b2Alloc(stateCapacity * sizeof(b2Position));
+			velocities = (b2Velocity*)b2Alloc(stateCapacity * sizeof(b2Velocity));
+		}
+
+		~b2IslandSolveScratch()
+		{
+			b2Free(velocities);
+			b2Free(positions);
+
+			allocator->~b2StackAllocator();
+			b2Free(allocator);
+		}
+
+		b2StackAllocator* allocator;
+		b2Position* positions;
+		b2Velocity* velocities;
+	};
+
+	b2IslandList* m_list;
+	int32 m_stateCapacity;
+	b2TimeStep m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+};
+
 b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = NULL;
 	g_debugDraw = NULL;
+	m_taskRunner = NULL;
 
 	m_bodyList = NULL;
 	m_jointList = NULL;
@@ -104,6 +248,11 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	g_debugDraw = debugDraw;
 }
 
+void b2World::SetTaskRunner(b2TaskRunner* taskRunner)
+{
+	m_taskRunner = taskRunner;
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -410,6 +559,30 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
+	// With a task runner, islands are only recorded here and solved together
+	// afterwards. These are sized for the worst case: every static body entry
+	// is added to an island through one of its contacts or joints.
+	b2IslandList list;
+	b2IslandList* parallelList = NULL;
+	if (m_taskRunner != NULL)
+	{
+		int32 contactCount = m_contactManager.m_contactCount;
+
+		list.islands = (b2IslandRecord*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRecord));
+		list.bodies = (b2Body**)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2Body*));
+		list.staticBodies = (b2Body**)m_stackAllocator.Allocate((contactCount + m_jointCount) * sizeof(b2Body*));
+		list.contacts = (b2Contact**)m_stackAllocator.Allocate(contactCount * sizeof(b2Contact*));
+		list.impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCount * sizeof(b2ContactImpulse));
+		list.joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+		list.islandCount = 0;
+		list.bodyCount = 0;
+		list.staticBodyCount = 0;
+		list.contactCount = 0;
+		list.jointCount = 0;
+		list.maxIslandBodyCount = 0;
+		parallelList = &list;
+	}
+
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
@@ -527,11 +700,18 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (parallelList != NULL)
+		{
+			parallelList->Add(island);
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -547,6 +727,18 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	if (parallelList != NULL)
+	{
+		SolveIslandsParallel(step, parallelList);
+
+		m_stackAllocator.Free(list.joints);
+		m_stackAllocator.Free(list.impulses);
+		m_stackAllocator.Free(list.contacts);
+		m_stackAllocator.Free(list.staticBodies);
+		m_stackAllocator.Free(list.bodies);
+		m_stackAllocator.Free(list.islands);
+	}
+
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
@@ -573,6 +765,77 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+void b2World::SolveIslandsParallel(const b2TimeStep& step, b2IslandList* list)
+{
+	b2Timer timer;
+
+	// Other bodies belong to a single island, so they're indexed within it.
+	for (int32 i = 0; i < list->islandCount; ++i)
+	{
+		const b2IslandRecord* r = list->islands + i;
+		for (int32 j = 0; j < r->bodyCount; ++j)
+		{
+			list->bodies[r->bodyIndex + j]->m_islandIndex = j;
+		}
+	}
+
+	// Static bodies may be shared by several islands, so each one gets a
+	// fixed slot in the state arrays, after the slots of the largest island.
+	for (int32 i = 0; i < list->staticBodyCount; ++i)
+	{
+		list->staticBodies[i]->m_islandIndex = -1;
+	}
+
+	int32 stateCapacity = list->maxIslandBodyCount;
+	for (int32 i = 0; i < list->staticBodyCount; ++i)
+	{
+		b2Body* b = list->staticBodies[i];
+		if (b->m_islandIndex == -1)
+		{
+			b->m_islandIndex = stateCapacity++;
+		}
+	}
+
+	b2IslandSolveTask task(list, stateCapacity, step, m_gravity, m_allowSleep);
+	m_taskRunner->RunTask(&task, list->islandCount);
+
+	// Report impulses and put islands to sleep in the order Solve would have.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < list->islandCount; ++i)
+	{
+		const b2IslandRecord* r = list->islands + i;
+
+		// Building the island woke its static bodies up.
+		for (int32 j = 0; j < r->staticBodyCount; ++j)
+		{
+			list->staticBodies[r->staticBodyIndex + j]->SetAwake(true);
+		}
+
+		if (listener != NULL)
+		{
+			for (int32 j = 0; j < r->contactCount; ++j)
+			{
+				int32 index = r->contactIndex + j;
+				listener->PostSolve(list->contacts[index], list->impulses + index);
+			}
+		}
+
+		if (r->asleep)
+		{
+			for (int32 j = 0; j < r->bodyCount; ++j)
+			{
+				list->bodies[r->bodyIndex + j]->SetAwake(false);
+			}
+			for (int32 j = 0; j < r->staticBodyCount; ++j)
+			{
+				list->staticBodies[r->staticBodyIndex + j]->SetAwake(false);
+			}
+		}
+	}
+
+	m_profile.solveVelocity += timer.GetMilliseconds();
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
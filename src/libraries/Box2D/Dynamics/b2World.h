@@ -29,6 +29,7 @@
 struct b2AABB;
 struct b2BodyDef;
 struct b2Color;
+struct b2IslandList;
 struct b2JointDef;
 class b2Body;
 class b2Draw;
@@ -66,6 +67,12 @@ class b2World
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task runner used to solve islands in parallel, or NULL to
+	/// solve them on the calling thread. Post-solve events are reported after
+	/// all islands are solved. The task runner is owned by you and must
+	/// remain in scope.
+	void SetTaskRunner(b2TaskRunner* taskRunner);
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -225,6 +232,7 @@ class b2World
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveIslandsParallel(const b2TimeStep& step, b2IslandList* list);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -248,6 +256,7 @@ class b2World
 
 	b2DestructionListener* m_destructionListener;
 	b2Draw* g_debugDraw;
+	b2TaskRunner* m_taskRunner;
 
 	// This is used to compute the time step ratio to
 	// support a variable time step.
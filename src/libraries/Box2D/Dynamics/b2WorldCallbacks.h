@@ -152,4 +152,28 @@ class b2RayCastCallback
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// A unit of work that can be split into ranges. See b2TaskRunner.
+class b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Process the items in [begin, end). May be called concurrently from
+	/// several threads with disjoint ranges.
+	virtual void Run(int32 begin, int32 end) = 0;
+};
+
+/// Implement this class to let the world solve islands on multiple threads.
+/// The results are identical to solving them on a single thread.
+/// See b2World::SetTaskRunner
+class b2TaskRunner
+{
+public:
+	virtual ~b2TaskRunner() {}
+
+	/// Call task->Run on disjoint ranges which together cover [0, count),
+	/// and return once all of them have finished.
+	virtual void RunTask(b2Task* task, int32 count) = 0;
+};
+
 #endif
@@ -108,6 +108,30 @@ class Audio : public Module
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source from the fully decoded contents of a Decoder.
+	 * The Decoder is rewound first. Static Sources created from identical
+	 * encoded data share their decoded audio while it's in the decoded audio
+	 * cache.
+	 **/
+	virtual Source *newStaticSource(love::sound::Decoder *decoder) = 0;
+
+	/**
+	 * Sets the maximum number of bytes of decoded audio kept in the cache
+	 * used by newStaticSource. Least recently used audio is removed from the
+	 * cache first. 0 disables the cache.
+	 **/
+	virtual void setDecodedCacheBudget(size_t bytes) = 0;
+	virtual size_t getDecodedCacheBudget() const = 0;
+
+	/**
+	 * Gets the number of bytes of decoded audio and the number of entries in
+	 * the decoded audio cache.
+	 **/
+	virtual void getDecodedCacheUsage(size_t &bytes, int &entries) const = 0;
+
+	static const size_t DEFAULT_DECODED_CACHE_BUDGET = 64 * 1024 * 1024;
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -29,6 +29,7 @@ namespace null
 
 Audio::Audio()
 	: distanceModel(DISTANCE_NONE)
+	, decodedCacheBudget(DEFAULT_DECODED_CACHE_BUDGET)
 {
 }
 
@@ -56,6 +57,27 @@ love::audio::Source *Audio::newSource(int, int, int, int)
 	return new Source();
 }
 
+love::audio::Source *Audio::newStaticSource(love::sound::Decoder *)
+{
+	return new Source();
+}
+
+void Audio::setDecodedCacheBudget(size_t bytes)
+{
+	decodedCacheBudget = bytes;
+}
+
+size_t Audio::getDecodedCacheBudget() const
+{
+	return decodedCacheBudget;
+}
+
+void Audio::getDecodedCacheUsage(size_t &bytes, int &entries) const
+{
+	bytes = 0;
+	entries = 0;
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return 0;
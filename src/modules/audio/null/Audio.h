@@ -48,6 +48,10 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newStaticSource(love::sound::Decoder *decoder);
+	void setDecodedCacheBudget(size_t bytes);
+	size_t getDecodedCacheBudget() const;
+	void getDecodedCacheUsage(size_t &bytes, int &entries) const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -92,6 +96,7 @@ class Audio : public love::audio::Audio
 private:
 	float volume;
 	DistanceModel distanceModel;
+	size_t decodedCacheBudget;
 	std::vector<love::audio::RecordingDevice*> capture;
 
 }; // Audio
@@ -22,6 +22,7 @@
 #include "common/delay.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
+#include "libraries/xxHash/xxhash.h"
 
 #include <cstdlib>
 #include <iostream>
@@ -61,15 +62,20 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Sleeps until a playing Source needs more audio or the pool is
+		// woken up, rather than polling.
+		pool->waitForUpdate(pool->update());
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
@@ -98,6 +104,8 @@ Audio::Audio()
 	, context(nullptr)
 	, pool(nullptr)
 	, poolThread(nullptr)
+	, decodedCacheBudget(DEFAULT_DECODED_CACHE_BUDGET)
+	, decodedCacheSize(0)
 	, distanceModel(DISTANCE_INVERSE_CLAMPED)
 {
 #if defined(LOVE_LINUX)
@@ -211,6 +219,10 @@ Audio::~Audio()
 	delete poolThread;
 	delete pool;
 
+	// The cached buffers need the context.
+	decodedCache.clear();
+	decodedCacheEntries.clear();
+
 	for (auto c : capture)
 		delete c;
 
@@ -255,6 +267,103 @@ love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels
 	return new Source(pool, sampleRate, bitDepth, channels, buffers);
 }
 
+love::audio::Source *Audio::newStaticSource(love::sound::Decoder *decoder)
+{
+	Data *encoded = decoder->getEncodedData();
+	uint64 key = 0;
+
+	// Cached audio is keyed by the whole encoded file, so it has to be decoded
+	// from the start even if the Decoder was already read from or seeked.
+	bool rewound = decoder->rewind();
+
+	// Hashing is done outside of the lock, since it can take a while for
+	// large files.
+	if (rewound && encoded != nullptr && getDecodedCacheBudget() > 0)
+		key = XXH64(encoded->getData(), encoded->getSize(), 0);
+
+	if (key != 0)
+	{
+		thread::Lock lock(decodedCacheMutex);
+
+		auto it = decodedCacheEntries.find(key);
+		if (it != decodedCacheEntries.end() && it->second->encodedSize == encoded->getSize())
+		{
+			decodedCache.splice(decodedCache.begin(), decodedCache, it->second);
+
+			const DecodedCacheEntry &entry = decodedCache.front();
+			return new Source(pool, entry.buffer, entry.sampleRate, entry.bitDepth, entry.channels);
+		}
+	}
+
+	StrongRef<love::sound::SoundData> soundData(new love::sound::SoundData(decoder), Acquire::NORETAIN);
+
+	int sampleRate = soundData->getSampleRate();
+	int bitDepth = soundData->getBitDepth();
+	int channels = soundData->getChannelCount();
+	ALenum fmt = getFormat(bitDepth, channels);
+
+	// Let the regular constructor deal with unsupported formats.
+	if (key == 0 || fmt == AL_NONE)
+		return new Source(pool, soundData);
+
+	StrongRef<StaticDataBuffer> buffer(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+	Source *source = new Source(pool, buffer, sampleRate, bitDepth, channels);
+
+	thread::Lock lock(decodedCacheMutex);
+
+	// Another thread may have decoded the same data in the meantime.
+	if (decodedCacheEntries.find(key) == decodedCacheEntries.end() && soundData->getSize() <= decodedCacheBudget)
+	{
+		trimDecodedCache(decodedCacheBudget - soundData->getSize());
+
+		DecodedCacheEntry entry;
+		entry.key = key;
+		entry.encodedSize = encoded->getSize();
+		entry.buffer = buffer;
+		entry.sampleRate = sampleRate;
+		entry.bitDepth = bitDepth;
+		entry.channels = channels;
+
+		decodedCache.push_front(entry);
+		decodedCacheEntries[key] = decodedCache.begin();
+		decodedCacheSize += soundData->getSize();
+	}
+
+	return source;
+}
+
+void Audio::setDecodedCacheBudget(size_t bytes)
+{
+	thread::Lock lock(decodedCacheMutex);
+	decodedCacheBudget = bytes;
+	trimDecodedCache(bytes);
+}
+
+size_t Audio::getDecodedCacheBudget() const
+{
+	thread::Lock lock(decodedCacheMutex);
+	return decodedCacheBudget;
+}
+
+void Audio::getDecodedCacheUsage(size_t &bytes, int &entries) const
+{
+	thread::Lock lock(decodedCacheMutex);
+	bytes = decodedCacheSize;
+	entries = (int) decodedCache.size();
+}
+
+void Audio::trimDecodedCache(size_t budget)
+{
+	// Sources using evicted audio keep their own reference to it.
+	while (!decodedCache.empty() && decodedCacheSize > budget)
+	{
+		const DecodedCacheEntry &entry = decodedCache.back();
+		decodedCacheSize -= (size_t) entry.buffer->getSize();
+		decodedCacheEntries.erase(entry.key);
+		decodedCache.pop_back();
+	}
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return pool->getActiveSourceCount();
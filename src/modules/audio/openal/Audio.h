@@ -23,6 +23,8 @@
 
 // STD
 #include <queue>
+#include <list>
+#include <unordered_map>
 #include <map>
 #include <vector>
 #include <stack>
@@ -62,6 +64,8 @@ namespace audio
 namespace openal
 {
 
+class StaticDataBuffer;
+
 class Audio : public love::audio::Audio
 {
 public:
@@ -85,6 +89,10 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newStaticSource(love::sound::Decoder *decoder);
+	void setDecodedCacheBudget(size_t bytes);
+	size_t getDecodedCacheBudget() const;
+	void getDecodedCacheUsage(size_t &bytes, int &entries) const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -129,6 +137,7 @@ class Audio : public love::audio::Audio
 
 private:
 	void initializeEFX();
+	void trimDecodedCache(size_t budget);
 	// The OpenAL device.
 	ALCdevice *device;
 
@@ -174,6 +183,25 @@ class Audio : public love::audio::Audio
 
 	PoolThread *poolThread;
 
+	struct DecodedCacheEntry
+	{
+		uint64 key;
+		size_t encodedSize;
+
+		StrongRef<StaticDataBuffer> buffer;
+		int sampleRate;
+		int bitDepth;
+		int channels;
+	};
+
+	// Decoded audio used by newStaticSource, keyed by a hash of the encoded
+	// data. Most recently used first.
+	std::list<DecodedCacheEntry> decodedCache;
+	std::unordered_map<uint64, std::list<DecodedCacheEntry>::iterator> decodedCacheEntries;
+	size_t decodedCacheBudget;
+	size_t decodedCacheSize;
+	love::thread::MutexRef decodedCacheMutex;
+
 	DistanceModel distanceModel;
 	//float metersPerUnit = 1.0;
 }; // Audio
@@ -21,6 +21,10 @@
 #include "Pool.h"
 
 #include "Source.h"
+#include "thread/parallel.h"
+
+// STD
+#include <algorithm>
 
 namespace love
 {
@@ -32,6 +36,7 @@ namespace openal
 Pool::Pool()
 	: sources()
 	, totalSources(0)
+	, wakePending(false)
 {
 	// Clear errors.
 	alGetError();
@@ -99,20 +104,72 @@ bool Pool::isPlaying(Source *s)
 	return p;
 }
 
-void Pool::update()
+int Pool::update()
 {
-	thread::Lock lock(mutex);
+	std::vector<StrongRef<Source>> todecode;
+	double delay = MAX_UPDATE_DELAY / 1000.0;
 
-	std::vector<Source *> torelease;
-
-	for (const auto &i : playing)
 	{
-		if (!i.first->update())
-			torelease.push_back(i.first);
+		thread::Lock lock(mutex);
+
+		std::vector<Source *> torelease;
+
+		for (const auto &i : playing)
+		{
+			Source *s = i.first;
+
+			if (!s->update())
+			{
+				torelease.push_back(s);
+				continue;
+			}
+
+			if (s->needsDecode())
+				todecode.emplace_back(s);
+
+			delay = std::min(delay, s->getUpdateDelay());
+		}
+
+		for (Source *s : torelease)
+			releaseSource(s);
 	}
 
-	for (Source *s : torelease)
-		releaseSource(s);
+	if (todecode.empty())
+		return std::max((int) (delay * 1000.0), MIN_UPDATE_DELAY);
+
+	// Decoding happens outside of the pool lock, so playing and changing
+	// Sources on other threads isn't held up by it, and streams are spread
+	// across multiple threads.
+	std::vector<char> decoded(todecode.size(), 0);
+
+	thread::parallelFor((int) todecode.size(), 1, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+			decoded[i] = todecode[i]->decodeStream() ? 1 : 0;
+	});
+
+	// Queue the new audio right away if there is any.
+	if (std::find(decoded.begin(), decoded.end(), 1) != decoded.end())
+		return 0;
+
+	return std::max((int) (delay * 1000.0), MIN_UPDATE_DELAY);
+}
+
+void Pool::waitForUpdate(int timeout)
+{
+	thread::Lock lock(mutex);
+
+	if (!wakePending && timeout > 0)
+		updateCond->wait(mutex, timeout);
+
+	wakePending = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(mutex);
+	wakePending = true;
+	updateCond->signal();
 }
 
 int Pool::getActiveSourceCount() const
@@ -142,6 +199,8 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 
 	playing.insert(std::make_pair(source, out));
 	source->retain();
+
+	wake();
 	return true;
 }
 
@@ -78,7 +78,24 @@ class Pool
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Updates the playing sources, and decodes more audio for streaming
+	 * sources without holding the pool lock. Returns the number of
+	 * milliseconds until the sources need to be updated again.
+	 **/
+	int update();
+
+	/**
+	 * Blocks until the given number of milliseconds have passed, or until
+	 * wake() is called.
+	 **/
+	void waitForUpdate(int timeout);
+
+	/**
+	 * Makes the next (or current) waitForUpdate return early, e.g. because a
+	 * Source started playing.
+	 **/
+	void wake();
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
@@ -101,6 +118,10 @@ class Pool
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	// Bounds for the time between updates, in milliseconds.
+	static const int MIN_UPDATE_DELAY = 1;
+	static const int MAX_UPDATE_DELAY = 50;
+
 	// OpenAL sources
 	ALuint sources[MAX_SOURCES];
 
@@ -117,6 +138,10 @@ class Pool
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Signalled by wake().
+	love::thread::ConditionalRef updateCond;
+	bool wakePending;
+
 }; // Pool
 
 } // openal
@@ -27,6 +27,8 @@
 // STD
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <cstring>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -141,6 +143,24 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
+Source::Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+{
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
+
 Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	: love::audio::Source(Source::TYPE_STREAM)
 	, pool(pool)
@@ -153,6 +173,8 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	if (Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount()) == AL_NONE)
 		throw InvalidFormatException(decoder->getChannelCount(), decoder->getBitDepth());
 
+	chunkData.resize((size_t) decoder->getSize() * STREAM_CHUNKS);
+
 	for (int i = 0; i < buffers; i++)
 	{
 		ALuint buf;
@@ -236,13 +258,17 @@ Source::Source(const Source &s)
 	, channels(s.channels)
 	, bitDepth(s.bitDepth)
 	, decoder(nullptr)
-	, toLoop(0)
 	, buffers(s.buffers)
 {
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
+			Lock l(s.decoderMutex);
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+		}
+
+		chunkData.resize(s.chunkData.size());
 	}
 	if (sourceType != TYPE_STATIC)
 	{
@@ -370,7 +396,7 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !isStreamFinished()))
 		return false;
 
 	ALenum state;
@@ -419,24 +445,25 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
-						alSourceQueueBuffers(source, 1, &buffer);
-					else
-						unusedBuffers.push(buffer);
-				}
+					if (!queuedChunks.empty())
+						queuedChunks.pop();
 
-				while (!unusedBuffers.empty())
-				{
-					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					// The next buffer starts over at the beginning of the
+					// stream, so the offset does too.
+					if (!queuedChunks.empty() && queuedChunks.front().restart)
 					{
-						alSourceQueueBuffers(source, 1, &b);
-						unusedBuffers.pop();
+						offsetSamples = 0;
+						queuedChunks.front().restart = false;
 					}
-					else
-						break;
+
+					unusedBuffers.push(buffer);
 				}
 
+				// The audio itself was decoded ahead of time by decodeStream,
+				// so this only needs to copy it into the free buffers.
+				while (!unusedBuffers.empty() && queueChunk(unusedBuffers.top()))
+					unusedBuffers.pop();
+
 				return true;
 			}
 			return false;
@@ -470,6 +497,10 @@ void Source::setPitch(float pitch)
 		alSourcef(source, AL_PITCH, pitch);
 
 	this->pitch = pitch;
+
+	// Queued buffers will finish at a different time now.
+	if (valid)
+		pool->wake();
 }
 
 float Source::getPitch() const
@@ -542,7 +573,15 @@ void Source::seek(double offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			// Chunks decoded before the seek (e.g. by the pool thread since
+			// stop() cleared them) would play before the new position. They're
+			// cleared while the decoder is still locked, so no decode can run
+			// in between.
+			{
+				Lock decoderlock(decoderMutex);
+				decoder->seek(offsetSeconds);
+				clearChunks();
+			}
 
 			if (wasPlaying)
 				play();
@@ -626,6 +665,7 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
+		Lock decoderlock(decoderMutex);
 		double seconds = decoder->getDuration();
 
 		if (unit == UNIT_SECONDS)
@@ -774,6 +814,24 @@ void Source::setLooping(bool enable)
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
 
 	looping = enable;
+
+	if (sourceType == TYPE_STREAM && enable)
+	{
+		Lock decoderlock(decoderMutex);
+		Lock chunklock(chunkMutex);
+
+		// Decoding stopped at the end of the stream, but it should continue
+		// from the start now.
+		if (decodeFinished)
+		{
+			decoder->rewind();
+			restartNextChunk = true;
+			decodeFinished = false;
+		}
+	}
+
+	if (valid)
+		pool->wake();
 }
 
 bool Source::isLooping() const
@@ -842,19 +900,23 @@ void Source::prepareAtomic()
 		alSourcei(source, AL_BUFFER, staticBuffer->getBuffer());
 		break;
 	case TYPE_STREAM:
+	{
+		// The first buffers are decoded right away, so playback can start.
+		Lock decoderlock(decoderMutex);
+
 		while (!unusedBuffers.empty())
 		{
-			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
-				break;
+			if (!queueChunk(unusedBuffers.top()))
+			{
+				decodeChunk();
+				if (!queueChunk(unusedBuffers.top()))
+					break;
+			}
 
-			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
-
-			if (decoder->isFinished())
-				break;
 		}
 		break;
+	}
 	case TYPE_QUEUE:
 	{
 		while (!streamBuffers.empty())
@@ -884,7 +946,11 @@ void Source::teardownAtomic()
 		ALuint buffers[MAX_BUFFERS];
 
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		{
+			Lock decoderlock(decoderMutex);
+			decoder->rewind();
+			clearChunks();
+		}
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -915,7 +981,6 @@ void Source::teardownAtomic()
 
 	alSourcei(source, AL_BUFFER, AL_NONE);
 
-	toLoop = 0;
 	valid = false;
 	offsetSamples = 0;
 }
@@ -1144,43 +1209,167 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+bool Source::needsDecode() const
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	if (sourceType != TYPE_STREAM)
+		return false;
 
-	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
-	if (decoded > 0)
+	Lock l(chunkMutex);
+	return !decodeFinished && chunkCount < STREAM_CHUNKS;
+}
+
+bool Source::decodeStream()
+{
+	Lock decoderlock(decoderMutex);
+
+	bool decoded = false;
+	while (decodeChunk())
+		decoded = true;
+
+	return decoded;
+}
+
+bool Source::decodeChunk()
+{
+	// The decoder mutex must be held by the caller.
+	int slot = 0;
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		Lock l(chunkMutex);
+		if (decodeFinished || chunkCount >= STREAM_CHUNKS)
+			return false;
 
-		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
-		else
-			decoded = 0;
+		slot = (firstChunk + chunkCount) % STREAM_CHUNKS;
 	}
 
-	if (decoder->isFinished() && isLooping())
+	int chunksize = decoder->getSize();
+	int decoded = std::min(std::max(decoder->decode(), 0), chunksize);
+
+	// Decoding into the free chunk doesn't need the chunk lock, since the
+	// pool thread only reads chunks which have been added.
+	if (decoded > 0)
+		memcpy(&chunkData[(size_t) slot * chunksize], decoder->getBuffer(), decoded);
+
+	bool restart = restartNextChunk;
+	bool finished = false;
+
+	restartNextChunk = false;
+
+	if (decoder->isFinished())
 	{
-		int queued, processed;
-		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
-		alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
-		if (queued > processed)
-			toLoop = queued-processed;
+		// An empty stream would otherwise loop forever without decoding
+		// anything.
+		if (isLooping() && !(restart && decoded == 0))
+		{
+			decoder->rewind();
+			restartNextChunk = true;
+		}
 		else
-			toLoop = buffers-processed;
-		d->rewind();
+			finished = true;
 	}
+	else if (decoded == 0)
+		restartNextChunk = restart;
 
-	if (toLoop > 0)
+	Lock l(chunkMutex);
+
+	if (decoded > 0)
 	{
-		if (--toLoop == 0)
-		{
-			offsetSamples = 0;
-		}
+		chunks[slot].size = decoded;
+		chunks[slot].restart = restart;
+		chunkCount++;
 	}
 
-	return decoded;
+	decodeFinished = finished;
+	return decoded > 0 && !finished;
+}
+
+bool Source::queueChunk(ALuint buffer)
+{
+	Lock l(chunkMutex);
+
+	if (chunkCount == 0)
+		return false;
+
+	StreamChunk chunk = chunks[firstChunk];
+	const char *data = &chunkData[(size_t) firstChunk * decoder->getSize()];
+
+	// OpenAL implementations are allowed to ignore 0-size alBufferData calls,
+	// but decodeChunk never adds empty chunks.
+	alBufferData(buffer, Audio::getFormat(bitDepth, channels), data, chunk.size, sampleRate);
+	alSourceQueueBuffers(source, 1, &buffer);
+
+	firstChunk = (firstChunk + 1) % STREAM_CHUNKS;
+	chunkCount--;
+
+	// Nothing else is queued, so the restarted stream begins playing now.
+	if (chunk.restart && queuedChunks.empty())
+	{
+		offsetSamples = 0;
+		chunk.restart = false;
+	}
+
+	queuedChunks.push(chunk);
+	return true;
+}
+
+void Source::clearChunks()
+{
+	// The decoder mutex must be held by the caller, so a decodeChunk can't
+	// publish a chunk decoded from before the clear.
+	Lock l(chunkMutex);
+
+	firstChunk = 0;
+	chunkCount = 0;
+	restartNextChunk = false;
+	decodeFinished = false;
+	queuedChunks = std::queue<StreamChunk>();
+}
+
+bool Source::isStreamFinished() const
+{
+	Lock l(chunkMutex);
+	return decodeFinished && chunkCount == 0;
+}
+
+double Source::getUpdateDelay() const
+{
+	// Used when there's no better estimate, e.g. for queueable sources.
+	const double defaultdelay = 0.005;
+
+	if (!valid)
+		return defaultdelay;
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	if (state == AL_PAUSED)
+		return std::numeric_limits<double>::infinity();
+	else if (state != AL_PLAYING)
+		return defaultdelay;
+
+	int samples = 0;
+
+	if (sourceType == TYPE_STATIC)
+	{
+		if (isLooping())
+			return std::numeric_limits<double>::infinity();
+
+		samples = staticBuffer->getSize() / (bitDepth / 8 * channels);
+	}
+	else if (sourceType == TYPE_STREAM)
+	{
+		if (queuedChunks.empty())
+			return defaultdelay;
+
+		samples = queuedChunks.front().size / (bitDepth / 8 * channels);
+	}
+	else
+		return defaultdelay;
+
+	// Time until the current buffer has finished playing.
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	return std::max(samples - offset, 0) / (sampleRate * std::max(pitch, 0.001f));
 }
 
 void Source::setMinVolume(float volume)
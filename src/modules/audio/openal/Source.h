@@ -28,12 +28,14 @@
 #include "audio/Filter.h"
 #include "sound/SoundData.h"
 #include "sound/Decoder.h"
+#include "thread/threads.h"
 #include "Audio.h"
 #include "Filter.h"
 
 // STL
 #include <vector>
 #include <stack>
+#include <queue>
 
 // C
 #include <float.h>
@@ -99,6 +101,7 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
+	Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels);
 	Source(Pool *pool, love::sound::Decoder *decoder);
 	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
 	Source(const Source &s);
@@ -160,6 +163,25 @@ class Source : public love::audio::Source
 	void prepareAtomic();
 	void teardownAtomic();
 
+	/**
+	 * Whether this streaming Source has room for more decoded audio.
+	 **/
+	bool needsDecode() const;
+
+	/**
+	 * Decodes audio ahead of playback until this streaming Source's decoded
+	 * chunks are full or the stream ends. Doesn't need the pool lock, so
+	 * streams can be decoded on any thread while others use the pool.
+	 * Returns true if anything was decoded.
+	 **/
+	bool decodeStream();
+
+	/**
+	 * Gets the number of seconds until this Source should be updated again,
+	 * e.g. because one of its queued buffers will have finished playing.
+	 **/
+	double getUpdateDelay() const;
+
 	bool playAtomic(ALuint source);
 	void stopAtomic();
 	void pauseAtomic();
@@ -178,7 +200,10 @@ class Source : public love::audio::Source
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	bool decodeChunk();
+	bool queueChunk(ALuint buffer);
+	void clearChunks();
+	bool isStreamFinished() const;
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
@@ -189,6 +214,37 @@ class Source : public love::audio::Source
 	std::queue<ALuint> streamBuffers;
 	std::stack<ALuint> unusedBuffers;
 
+	// Streaming sources decode this many chunks ahead of the buffers queued
+	// in OpenAL.
+	const static int STREAM_CHUNKS = 4;
+
+	struct StreamChunk
+	{
+		int size;
+
+		// Whether the chunk starts over at the beginning of a looping stream.
+		bool restart;
+	};
+
+	// Decoded chunks waiting to be copied into OpenAL buffers, stored in a
+	// ring in chunkData.
+	std::vector<char> chunkData;
+	StreamChunk chunks[STREAM_CHUNKS];
+	int firstChunk = 0;
+	int chunkCount = 0;
+
+	bool restartNextChunk = false;
+	bool decodeFinished = false;
+
+	// The chunks in the OpenAL source's buffer queue, in playback order.
+	std::queue<StreamChunk> queuedChunks;
+
+	// Held while the decoder is in use.
+	love::thread::MutexRef decoderMutex;
+
+	// Guards the decoded chunks and decodeFinished.
+	love::thread::MutexRef chunkMutex;
+
 	StrongRef<StaticDataBuffer> staticBuffer;
 
 	float pitch = 1.0f;
@@ -221,7 +277,6 @@ class Source : public love::audio::Source
 
 	StrongRef<love::sound::Decoder> decoder;
 
-	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
 
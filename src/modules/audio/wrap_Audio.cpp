@@ -60,14 +60,13 @@ int w_newSource(lua_State *L)
 	if (lua_isstring(L, 1) || luax_istype(L, 1, love::filesystem::File::type) || luax_istype(L, 1, love::filesystem::FileData::type))
 		luax_convobj(L, 1, "sound", "newDecoder");
 
-	if (stype == Source::TYPE_STATIC && luax_istype(L, 1, love::sound::Decoder::type))
-		luax_convobj(L, 1, "sound", "newSoundData");
-
 	Source *t = nullptr;
 
 	luax_catchexcept(L, [&]() {
 		if (luax_istype(L, 1, love::sound::SoundData::type))
 			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
+		else if (stype == Source::TYPE_STATIC && luax_istype(L, 1, love::sound::Decoder::type))
+			t = instance()->newStaticSource(luax_totype<love::sound::Decoder>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
 	});
@@ -530,6 +529,33 @@ int w_setMixWithSystem(lua_State *L)
 	return 1;
 }
 
+int w_setDecodedCacheBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Decoded audio cache budget must not be negative.");
+
+	instance()->setDecodedCacheBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getDecodedCacheBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getDecodedCacheBudget());
+	return 1;
+}
+
+int w_getDecodedCacheUsage(lua_State *L)
+{
+	size_t bytes = 0;
+	int entries = 0;
+	instance()->getDecodedCacheUsage(bytes, entries);
+
+	lua_pushnumber(L, (lua_Number) bytes);
+	lua_pushinteger(L, entries);
+	return 2;
+}
+
 int w_getSourceCount(lua_State *L)
 {
 	luax_markdeprecated(L, "love.audio.getSourceCount", API_FUNCTION, DEPRECATED_RENAMED, "love.audio.getActiveSourceCount");
@@ -567,6 +593,9 @@ static const luaL_Reg functions[] =
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
 	{ "setMixWithSystem", w_setMixWithSystem },
+	{ "setDecodedCacheBudget", w_setDecodedCacheBudget },
+	{ "getDecodedCacheBudget", w_getDecodedCacheBudget },
+	{ "getDecodedCacheUsage", w_getDecodedCacheUsage },
 
 	// Deprecated
 	{ "getSourceCount", w_getSourceCount },
@@ -0,0 +1,571 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "CompressStream.h"
+#include "common/config.h"
+#include "common/Exception.h"
+#include "common/int.h"
+
+#include "libraries/lz4/lz4.h"
+#include "libraries/lz4/lz4hc.h"
+
+#include <zlib.h>
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace love
+{
+namespace data
+{
+
+love::Type CompressStream::type("CompressStream", &Object::type);
+love::Type DecompressStream::type("DecompressStream", &Object::type);
+
+CompressionStream::CompressionStream(Compressor::Format format, const Output &output)
+	: format(format)
+	, finished(false)
+	, output(output)
+{
+}
+
+bool CompressionStream::isFinished() const
+{
+	return finished;
+}
+
+Compressor::Format CompressionStream::getFormat() const
+{
+	return format;
+}
+
+std::vector<char> &CompressionStream::getPendingOutput()
+{
+	return pendingOutput;
+}
+
+void CompressionStream::emit(const char *data, size_t size)
+{
+	if (size == 0)
+		return;
+
+	if (output)
+		output(data, size);
+	else
+		pendingOutput.insert(pendingOutput.end(), data, data + size);
+}
+
+CompressStream::CompressStream(Compressor::Format format, const Output &output)
+	: CompressionStream(format, output)
+{
+}
+
+DecompressStream::DecompressStream(Compressor::Format format, const Output &output)
+	: CompressionStream(format, output)
+{
+}
+
+void DecompressStream::finish()
+{
+	if (!finished)
+		throw love::Exception("Compressed stream ended before it was complete.");
+}
+
+namespace
+{
+
+// Size of the buffer compressed or decompressed zlib output goes through.
+const size_t ZLIB_OUTPUT_CHUNK_SIZE = 16 * 1024;
+
+// LZ4 streams are made of blocks of up to this much uncompressed data. Each
+// block starts with a header of two little-endian uint32s: the uncompressed
+// and compressed sizes. A block with both sizes set to 0 ends the stream.
+const int LZ4_BLOCK_SIZE = 64 * 1024;
+const size_t LZ4_BLOCK_HEADER_SIZE = sizeof(uint32) * 2;
+
+inline void writeUint32LE(char *dst, uint32 value)
+{
+#ifdef LOVE_BIG_ENDIAN
+	value = swapuint32(value);
+#endif
+	memcpy(dst, &value, sizeof(uint32));
+}
+
+inline uint32 readUint32LE(const char *src)
+{
+	uint32 value = 0;
+	memcpy(&value, src, sizeof(uint32));
+#ifdef LOVE_BIG_ENDIAN
+	value = swapuint32(value);
+#endif
+	return value;
+}
+
+int getZlibWindowBits(Compressor::Format format)
+{
+	if (format == Compressor::FORMAT_GZIP)
+		return 15 + 16; // This tells zlib to use a gzip header.
+	else if (format == Compressor::FORMAT_DEFLATE)
+		return -15;
+	else
+		return 15;
+}
+
+class zlibCompressStream : public CompressStream
+{
+public:
+
+	zlibCompressStream(Compressor::Format format, int level, const Output &output)
+		: CompressStream(format, output)
+		, stream()
+	{
+		if (level < 0)
+			level = Z_DEFAULT_COMPRESSION;
+		else if (level > 9)
+			level = 9;
+
+		if (deflateInit2(&stream, level, Z_DEFLATED, getZlibWindowBits(format), 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw love::Exception("Could not create zlib/gzip compression stream.");
+	}
+
+	virtual ~zlibCompressStream()
+	{
+		deflateEnd(&stream);
+	}
+
+	void write(const void *data, size_t size) override
+	{
+		if (finished)
+			throw love::Exception("Cannot write to a finished compression stream.");
+
+		const char *bytes = (const char *) data;
+
+		// zlib can only take so much input at once.
+		while (size > 0)
+		{
+			uInt chunksize = (uInt) std::min(size, (size_t) std::numeric_limits<uInt>::max());
+
+			stream.next_in = (Bytef *) bytes;
+			stream.avail_in = chunksize;
+			deflateOutput(Z_NO_FLUSH);
+
+			bytes += chunksize;
+			size -= chunksize;
+		}
+	}
+
+	void flush() override
+	{
+		if (finished)
+			throw love::Exception("Cannot flush a finished compression stream.");
+
+		deflateOutput(Z_SYNC_FLUSH);
+	}
+
+	void finish() override
+	{
+		if (finished)
+			return;
+
+		deflateOutput(Z_FINISH);
+		finished = true;
+	}
+
+private:
+
+	void deflateOutput(int flush)
+	{
+		char buffer[ZLIB_OUTPUT_CHUNK_SIZE];
+
+		while (true)
+		{
+			stream.next_out = (Bytef *) buffer;
+			stream.avail_out = (uInt) sizeof(buffer);
+
+			int err = deflate(&stream, flush);
+			if (err == Z_STREAM_ERROR)
+				throw love::Exception("Could not zlib/gzip-compress data.");
+
+			emit(buffer, sizeof(buffer) - stream.avail_out);
+
+			if (flush == Z_FINISH ? err == Z_STREAM_END : stream.avail_out != 0)
+				break;
+		}
+	}
+
+	z_stream stream;
+
+}; // zlibCompressStream
+
+class zlibDecompressStream : public DecompressStream
+{
+public:
+
+	zlibDecompressStream(Compressor::Format format, const Output &output)
+		: DecompressStream(format, output)
+		, stream()
+	{
+		// Adding 32 makes zlib auto-detect the header type.
+		int windowbits = getZlibWindowBits(format);
+		if (format != Compressor::FORMAT_DEFLATE)
+			windowbits = 15 + 32;
+
+		if (inflateInit2(&stream, windowbits) != Z_OK)
+			throw love::Exception("Could not create zlib/gzip decompression stream.");
+	}
+
+	virtual ~zlibDecompressStream()
+	{
+		inflateEnd(&stream);
+	}
+
+	void write(const void *data, size_t size) override
+	{
+		const char *bytes = (const char *) data;
+		char buffer[ZLIB_OUTPUT_CHUNK_SIZE];
+
+		while (size > 0)
+		{
+			if (finished)
+			{
+				// gzip files can be several gzip streams one after another.
+				if (format != Compressor::FORMAT_GZIP)
+					throw love::Exception("Cannot write past the end of a compressed stream.");
+
+				if (inflateReset(&stream) != Z_OK)
+					throw love::Exception("Could not decompress zlib/gzip-compressed data.");
+
+				finished = false;
+			}
+
+			uInt chunksize = (uInt) std::min(size, (size_t) std::numeric_limits<uInt>::max());
+
+			stream.next_in = (Bytef *) bytes;
+			stream.avail_in = chunksize;
+
+			do
+			{
+				stream.next_out = (Bytef *) buffer;
+				stream.avail_out = (uInt) sizeof(buffer);
+
+				int err = inflate(&stream, Z_NO_FLUSH);
+				if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR)
+					throw love::Exception("Could not decompress zlib/gzip-compressed data.");
+
+				emit(buffer, sizeof(buffer) - stream.avail_out);
+
+				if (err == Z_STREAM_END)
+				{
+					finished = true;
+					break;
+				}
+			}
+			while (stream.avail_out == 0);
+
+			// Input after the end of the stream is left unread.
+			size_t readsize = chunksize - stream.avail_in;
+			bytes += readsize;
+			size -= readsize;
+		}
+	}
+
+private:
+
+	z_stream stream;
+
+}; // zlibDecompressStream
+
+class LZ4CompressStream : public CompressStream
+{
+public:
+
+	LZ4CompressStream(int level, const Output &output)
+		: CompressStream(Compressor::FORMAT_LZ4, output)
+		, stream(nullptr)
+		, streamHC(nullptr)
+		, inputBuffers(LZ4_BLOCK_SIZE * 2)
+		, bufferIndex(0)
+		, bufferedSize(0)
+		, block(LZ4_BLOCK_HEADER_SIZE + LZ4_COMPRESSBOUND(LZ4_BLOCK_SIZE))
+	{
+		// Use LZ4-HC for compression level 9 and higher, like compress().
+		if (level > 8)
+		{
+			streamHC = LZ4_createStreamHC();
+			if (streamHC != nullptr)
+				LZ4_resetStreamHC(streamHC, std::min(level, LZ4HC_CLEVEL_MAX));
+		}
+		else
+			stream = LZ4_createStream();
+
+		if (stream == nullptr && streamHC == nullptr)
+			throw love::Exception("Could not create LZ4 compression stream.");
+	}
+
+	virtual ~LZ4CompressStream()
+	{
+		if (stream != nullptr)
+			LZ4_freeStream(stream);
+		if (streamHC != nullptr)
+			LZ4_freeStreamHC(streamHC);
+	}
+
+	void write(const void *data, size_t size) override
+	{
+		if (finished)
+			throw love::Exception("Cannot write to a finished compression stream.");
+
+		const char *bytes = (const char *) data;
+
+		while (size > 0)
+		{
+			size_t copysize = std::min(size, (size_t) (LZ4_BLOCK_SIZE - bufferedSize));
+			memcpy(getInputBuffer() + bufferedSize, bytes, copysize);
+
+			bufferedSize += (int) copysize;
+			bytes += copysize;
+			size -= copysize;
+
+			if (bufferedSize == LZ4_BLOCK_SIZE)
+				compressBlock();
+		}
+	}
+
+	void flush() override
+	{
+		if (finished)
+			throw love::Exception("Cannot flush a finished compression stream.");
+
+		compressBlock();
+	}
+
+	void finish() override
+	{
+		if (finished)
+			return;
+
+		compressBlock();
+
+		char end[LZ4_BLOCK_HEADER_SIZE] = {};
+		emit(end, sizeof(end));
+
+		finished = true;
+	}
+
+private:
+
+	char *getInputBuffer()
+	{
+		return &inputBuffers[bufferIndex * LZ4_BLOCK_SIZE];
+	}
+
+	void compressBlock()
+	{
+		if (bufferedSize == 0)
+			return;
+
+		const char *src = getInputBuffer();
+		char *dst = &block[LZ4_BLOCK_HEADER_SIZE];
+		int maxdstsize = (int) (block.size() - LZ4_BLOCK_HEADER_SIZE);
+
+		int csize = 0;
+		if (streamHC != nullptr)
+			csize = LZ4_compress_HC_continue(streamHC, src, dst, bufferedSize, maxdstsize);
+		else
+			csize = LZ4_compress_fast_continue(stream, src, dst, bufferedSize, maxdstsize, 1);
+
+		if (csize <= 0)
+			throw love::Exception("Could not LZ4-compress data.");
+
+		writeUint32LE(&block[0], (uint32) bufferedSize);
+		writeUint32LE(&block[sizeof(uint32)], (uint32) csize);
+		emit(&block[0], LZ4_BLOCK_HEADER_SIZE + csize);
+
+		// The previous block has to stay in memory, since LZ4 uses it as the
+		// dictionary for the next one.
+		bufferIndex = 1 - bufferIndex;
+		bufferedSize = 0;
+	}
+
+	LZ4_stream_t *stream;
+	LZ4_streamHC_t *streamHC;
+
+	std::vector<char> inputBuffers;
+	int bufferIndex;
+	int bufferedSize;
+
+	std::vector<char> block;
+
+}; // LZ4CompressStream
+
+class LZ4DecompressStream : public DecompressStream
+{
+public:
+
+	LZ4DecompressStream(const Output &output)
+		: DecompressStream(Compressor::FORMAT_LZ4, output)
+		, stream(LZ4_createStreamDecode())
+		, outputBuffers(LZ4_BLOCK_SIZE * 2)
+		, bufferIndex(0)
+		, failed(false)
+	{
+		if (stream == nullptr)
+			throw love::Exception("Could not create LZ4 decompression stream.");
+
+		block.reserve(LZ4_BLOCK_HEADER_SIZE + LZ4_COMPRESSBOUND(LZ4_BLOCK_SIZE));
+	}
+
+	virtual ~LZ4DecompressStream()
+	{
+		LZ4_freeStreamDecode(stream);
+	}
+
+	void write(const void *data, size_t size) override
+	{
+		if (failed)
+			throw love::Exception("Cannot write to a decompression stream after an error.");
+
+		if (finished && size > 0)
+			throw love::Exception("Cannot write past the end of a compressed stream.");
+
+		const char *bytes = (const char *) data;
+
+		while (size > 0 && !finished)
+		{
+			// Collect the header first, then the rest of the block.
+			size_t needed = LZ4_BLOCK_HEADER_SIZE;
+			if (block.size() >= LZ4_BLOCK_HEADER_SIZE)
+				needed += getCompressedSize();
+
+			size_t copysize = std::min(size, needed - block.size());
+			block.insert(block.end(), bytes, bytes + copysize);
+			bytes += copysize;
+			size -= copysize;
+
+			if (block.size() == LZ4_BLOCK_HEADER_SIZE)
+				checkHeader();
+
+			if (block.size() >= LZ4_BLOCK_HEADER_SIZE && block.size() == LZ4_BLOCK_HEADER_SIZE + getCompressedSize())
+				decompressBlock();
+		}
+	}
+
+private:
+
+	uint32 getRawSize() const
+	{
+		return readUint32LE(&block[0]);
+	}
+
+	uint32 getCompressedSize() const
+	{
+		return readUint32LE(&block[sizeof(uint32)]);
+	}
+
+	// The block can't be trusted after an error, so the stream stops taking
+	// input instead of collecting a block of whatever size it claims.
+	void fail(const char *message)
+	{
+		failed = true;
+		block.clear();
+		throw love::Exception("%s", message);
+	}
+
+	void checkHeader()
+	{
+		uint32 rawsize = getRawSize();
+		uint32 csize = getCompressedSize();
+
+		if (rawsize > (uint32) LZ4_BLOCK_SIZE || csize > (uint32) LZ4_COMPRESSBOUND(LZ4_BLOCK_SIZE) || (csize == 0) != (rawsize == 0))
+			fail("Invalid LZ4 stream block.");
+	}
+
+	void decompressBlock()
+	{
+		uint32 rawsize = getRawSize();
+		uint32 csize = getCompressedSize();
+
+		if (rawsize == 0)
+		{
+			finished = true;
+			block.clear();
+			return;
+		}
+
+		char *dst = &outputBuffers[bufferIndex * LZ4_BLOCK_SIZE];
+		int result = LZ4_decompress_safe_continue(stream, &block[LZ4_BLOCK_HEADER_SIZE], dst, (int) csize, LZ4_BLOCK_SIZE);
+
+		if (result < 0 || (uint32) result != rawsize)
+			fail("Could not decompress LZ4-compressed data.");
+
+		emit(dst, rawsize);
+
+		// Keep this block around as the dictionary for the next one.
+		bufferIndex = 1 - bufferIndex;
+		block.clear();
+	}
+
+	LZ4_streamDecode_t *stream;
+
+	std::vector<char> outputBuffers;
+	int bufferIndex;
+
+	std::vector<char> block;
+	bool failed;
+
+}; // LZ4DecompressStream
+
+} // anonymous namespace
+
+CompressStream *CompressStream::create(Compressor::Format format, int level, const Output &output)
+{
+	switch (format)
+	{
+	case Compressor::FORMAT_LZ4:
+		return new LZ4CompressStream(level, output);
+	case Compressor::FORMAT_ZLIB:
+	case Compressor::FORMAT_GZIP:
+	case Compressor::FORMAT_DEFLATE:
+		return new zlibCompressStream(format, level, output);
+	default:
+		throw love::Exception("No compression stream available for the given format.");
+	}
+}
+
+DecompressStream *DecompressStream::create(Compressor::Format format, const Output &output)
+{
+	switch (format)
+	{
+	case Compressor::FORMAT_LZ4:
+		return new LZ4DecompressStream(output);
+	case Compressor::FORMAT_ZLIB:
+	case Compressor::FORMAT_GZIP:
+	case Compressor::FORMAT_DEFLATE:
+		return new zlibDecompressStream(format, output);
+	default:
+		throw love::Exception("No decompression stream available for the given format.");
+	}
+}
+
+} // data
+} // love
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "Compressor.h"
+
+// C++
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace data
+{
+
+/**
+ * Base class for compression and decompression streams, which process data
+ * incrementally instead of all at once.
+ **/
+class CompressionStream : public Object
+{
+public:
+
+	/**
+	 * Receives the output of a stream as it's produced.
+	 **/
+	typedef std::function<void(const char *data, size_t size)> Output;
+
+	virtual ~CompressionStream() {}
+
+	/**
+	 * Processes more input, producing any output that's ready.
+	 **/
+	virtual void write(const void *data, size_t size) = 0;
+
+	/**
+	 * Gets whether the end of the stream has been reached.
+	 **/
+	bool isFinished() const;
+
+	Compressor::Format getFormat() const;
+
+	/**
+	 * Gets the output produced since the last call, when there's no Output
+	 * function. The caller should clear it once it's been used, to keep the
+	 * stream's memory use bounded.
+	 **/
+	std::vector<char> &getPendingOutput();
+
+protected:
+
+	CompressionStream(Compressor::Format format, const Output &output);
+
+	void emit(const char *data, size_t size);
+
+	Compressor::Format format;
+	bool finished;
+
+private:
+
+	Output output;
+	std::vector<char> pendingOutput;
+
+}; // CompressionStream
+
+/**
+ * Compresses data incrementally. The output of zlib, gzip and deflate streams
+ * can be decompressed with love.data.decompress. LZ4 streams are split into
+ * blocks and can only be read by a DecompressStream.
+ **/
+class CompressStream : public CompressionStream
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * Creates a stream for the given format. Compressed output is sent to the
+	 * output function if one is given, and kept as pending output otherwise.
+	 **/
+	static CompressStream *create(Compressor::Format format, int level, const Output &output = Output());
+
+	virtual ~CompressStream() {}
+
+	/**
+	 * Outputs all the compressed data for the input so far, so it can be
+	 * decompressed without waiting for the rest of the stream.
+	 **/
+	virtual void flush() = 0;
+
+	/**
+	 * Outputs the rest of the compressed data and ends the stream.
+	 **/
+	virtual void finish() = 0;
+
+protected:
+
+	CompressStream(Compressor::Format format, const Output &output);
+
+}; // CompressStream
+
+/**
+ * Decompresses data produced by a CompressStream (or any zlib, gzip or
+ * deflate data) incrementally. Concatenated gzip streams are decompressed as
+ * one, like gunzip does.
+ **/
+class DecompressStream : public CompressionStream
+{
+public:
+
+	static love::Type type;
+
+	static DecompressStream *create(Compressor::Format format, const Output &output = Output());
+
+	virtual ~DecompressStream() {}
+
+	/**
+	 * Throws an exception if the end of the compressed stream hasn't been
+	 * reached.
+	 **/
+	void finish();
+
+protected:
+
+	DecompressStream(Compressor::Format format, const Output &output);
+
+}; // DecompressStream
+
+} // data
+} // love
@@ -241,6 +241,16 @@ ByteData *DataModule::newByteData(void *d, size_t size, bool own)
 	return new ByteData(d, size, own);
 }
 
+CompressStream *DataModule::newCompressStream(Compressor::Format format, int level, const CompressionStream::Output &output)
+{
+	return CompressStream::create(format, level, output);
+}
+
+DecompressStream *DataModule::newDecompressStream(Compressor::Format format, const CompressionStream::Output &output)
+{
+	return DecompressStream::create(format, output);
+}
+
 static StringMap<EncodeFormat, ENCODE_MAX_ENUM>::Entry encoderEntries[] =
 {
 	{ "base64", ENCODE_BASE64 },
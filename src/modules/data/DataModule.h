@@ -25,6 +25,7 @@
 #include "HashFunction.h"
 #include "DataView.h"
 #include "ByteData.h"
+#include "CompressStream.h"
 
 // LOVE
 #include "common/Module.h"
@@ -125,6 +126,8 @@ class DataModule : public Module
 	ByteData *newByteData(size_t size);
 	ByteData *newByteData(const void *d, size_t size);
 	ByteData *newByteData(void *d, size_t size, bool own);
+	CompressStream *newCompressStream(Compressor::Format format, int level = -1, const CompressionStream::Output &output = CompressionStream::Output());
+	DecompressStream *newDecompressStream(Compressor::Format format, const CompressionStream::Output &output = CompressionStream::Output());
 
 }; // DataModule
 
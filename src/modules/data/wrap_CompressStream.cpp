@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_CompressStream.h"
+#include "common/Data.h"
+
+namespace love
+{
+namespace data
+{
+
+CompressStream *luax_checkcompressstream(lua_State *L, int idx)
+{
+	return luax_checktype<CompressStream>(L, idx);
+}
+
+DecompressStream *luax_checkdecompressstream(lua_State *L, int idx)
+{
+	return luax_checktype<DecompressStream>(L, idx);
+}
+
+static void checkStreamInput(lua_State *L, int idx, const char *&bytes, size_t &size)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		bytes = (const char *) data->getData();
+		size = data->getSize();
+	}
+	else
+		bytes = luaL_checklstring(L, idx, &size);
+}
+
+// Returns whatever output the stream produced since the last call, when it
+// isn't writing to a File.
+static int pushPendingOutput(lua_State *L, CompressionStream *stream)
+{
+	std::vector<char> &pending = stream->getPendingOutput();
+	lua_pushlstring(L, pending.data(), pending.size());
+	pending.clear();
+	return 1;
+}
+
+static int pushFormat(lua_State *L, CompressionStream *stream)
+{
+	const char *fname = nullptr;
+	if (!Compressor::getConstant(stream->getFormat(), fname))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(Compressor::FORMAT_MAX_ENUM), fname);
+
+	lua_pushstring(L, fname);
+	return 1;
+}
+
+int w_CompressStream_write(lua_State *L)
+{
+	CompressStream *t = luax_checkcompressstream(L, 1);
+
+	const char *bytes = nullptr;
+	size_t size = 0;
+	checkStreamInput(L, 2, bytes, size);
+
+	luax_catchexcept(L, [&](){ t->write(bytes, size); });
+	return pushPendingOutput(L, t);
+}
+
+int w_CompressStream_flush(lua_State *L)
+{
+	CompressStream *t = luax_checkcompressstream(L, 1);
+	luax_catchexcept(L, [&](){ t->flush(); });
+	return pushPendingOutput(L, t);
+}
+
+int w_CompressStream_finish(lua_State *L)
+{
+	CompressStream *t = luax_checkcompressstream(L, 1);
+	luax_catchexcept(L, [&](){ t->finish(); });
+	return pushPendingOutput(L, t);
+}
+
+int w_CompressStream_isFinished(lua_State *L)
+{
+	CompressStream *t = luax_checkcompressstream(L, 1);
+	luax_pushboolean(L, t->isFinished());
+	return 1;
+}
+
+int w_CompressStream_getFormat(lua_State *L)
+{
+	return pushFormat(L, luax_checkcompressstream(L, 1));
+}
+
+int w_DecompressStream_write(lua_State *L)
+{
+	DecompressStream *t = luax_checkdecompressstream(L, 1);
+
+	const char *bytes = nullptr;
+	size_t size = 0;
+	checkStreamInput(L, 2, bytes, size);
+
+	luax_catchexcept(L, [&](){ t->write(bytes, size); });
+	return pushPendingOutput(L, t);
+}
+
+int w_DecompressStream_finish(lua_State *L)
+{
+	DecompressStream *t = luax_checkdecompressstream(L, 1);
+	luax_catchexcept(L, [&](){ t->finish(); });
+	return 0;
+}
+
+int w_DecompressStream_isFinished(lua_State *L)
+{
+	DecompressStream *t = luax_checkdecompressstream(L, 1);
+	luax_pushboolean(L, t->isFinished());
+	return 1;
+}
+
+int w_DecompressStream_getFormat(lua_State *L)
+{
+	return pushFormat(L, luax_checkdecompressstream(L, 1));
+}
+
+static const luaL_Reg w_CompressStream_functions[] =
+{
+	{ "write", w_CompressStream_write },
+	{ "flush", w_CompressStream_flush },
+	{ "finish", w_CompressStream_finish },
+	{ "isFinished", w_CompressStream_isFinished },
+	{ "getFormat", w_CompressStream_getFormat },
+	{ 0, 0 },
+};
+
+static const luaL_Reg w_DecompressStream_functions[] =
+{
+	{ "write", w_DecompressStream_write },
+	{ "finish", w_DecompressStream_finish },
+	{ "isFinished", w_DecompressStream_isFinished },
+	{ "getFormat", w_DecompressStream_getFormat },
+	{ 0, 0 },
+};
+
+extern "C" int luaopen_compressstream(lua_State *L)
+{
+	return luax_register_type(L, &CompressStream::type, w_CompressStream_functions, nullptr);
+}
+
+extern "C" int luaopen_decompressstream(lua_State *L)
+{
+	return luax_register_type(L, &DecompressStream::type, w_DecompressStream_functions, nullptr);
+}
+
+} // data
+} // love
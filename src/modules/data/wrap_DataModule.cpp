@@ -24,8 +24,10 @@
 #include "wrap_ByteData.h"
 #include "wrap_DataView.h"
 #include "wrap_CompressedData.h"
+#include "wrap_CompressStream.h"
 #include "DataModule.h"
 #include "common/b64.h"
+#include "filesystem/File.h"
 
 // Lua 5.3
 #include "libraries/lua53/lstrlib.h"
@@ -113,6 +115,65 @@ int w_newByteData(lua_State *L)
 	return 1;
 }
 
+// Output function which writes a stream's output straight to a File, so it
+// never has to be held in memory.
+static CompressionStream::Output luax_optstreamfile(lua_State *L, int idx)
+{
+	if (lua_isnoneornil(L, idx))
+		return CompressionStream::Output();
+
+	filesystem::File *file = luax_checktype<filesystem::File>(L, idx);
+	filesystem::File::Mode mode = file->getMode();
+
+	if (mode != filesystem::File::MODE_WRITE && mode != filesystem::File::MODE_APPEND)
+		luaL_error(L, "File must be opened for writing or appending.");
+
+	StrongRef<filesystem::File> ref(file);
+
+	return [ref](const char *data, size_t size)
+	{
+		if (!ref->write(data, (int64) size))
+			throw love::Exception("Could not write to file.");
+	};
+}
+
+int w_newCompressStream(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	int level = (int) luaL_optinteger(L, 2, -1);
+	CompressionStream::Output output = luax_optstreamfile(L, 3);
+
+	CompressStream *s = nullptr;
+	luax_catchexcept(L, [&]() { s = instance()->newCompressStream(format, level, output); });
+	luax_pushtype(L, s);
+	s->release();
+
+	return 1;
+}
+
+int w_newDecompressStream(lua_State *L)
+{
+	const char *fstr = luaL_checkstring(L, 1);
+	Compressor::Format format = Compressor::FORMAT_LZ4;
+
+	if (!Compressor::getConstant(fstr, format))
+		return luax_enumerror(L, "compressed data format", Compressor::getConstants(format), fstr);
+
+	CompressionStream::Output output = luax_optstreamfile(L, 2);
+
+	DecompressStream *s = nullptr;
+	luax_catchexcept(L, [&]() { s = instance()->newDecompressStream(format, output); });
+	luax_pushtype(L, s);
+	s->release();
+
+	return 1;
+}
+
 int w_compress(lua_State *L)
 {
 	ContainerType ctype = luax_checkcontainertype(L, 1);
@@ -373,6 +434,8 @@ static const luaL_Reg functions[] =
 	{ "newByteData", w_newByteData },
 	{ "compress", w_compress },
 	{ "decompress", w_decompress },
+	{ "newCompressStream", w_newCompressStream },
+	{ "newDecompressStream", w_newDecompressStream },
 	{ "encode", w_encode },
 	{ "decode", w_decode },
 	{ "hash", w_hash },
@@ -390,6 +453,8 @@ static const lua_CFunction types[] =
 	luaopen_bytedata,
 	luaopen_dataview,
 	luaopen_compresseddata,
+	luaopen_compressstream,
+	luaopen_decompressstream,
 	nullptr
 };
 
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "AsyncReader.h"
+#include "Filesystem.h"
+
+// C++
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace filesystem
+{
+
+AsyncReader::AsyncReader(Filesystem *filesystem)
+	: filesystem(filesystem)
+	, nextOrder(0)
+	, quit(false)
+{
+	// Reads mostly wait on storage, so a few threads are worthwhile even on
+	// machines with a single core.
+	int count = std::max(std::min((int) std::thread::hardware_concurrency(), (int) MAX_THREADS), 2);
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		if (worker->start())
+			workers.push_back(worker);
+		else
+			worker->release();
+	}
+
+	if (workers.empty())
+		throw love::Exception("Could not start the file reading threads.");
+}
+
+AsyncReader::~AsyncReader()
+{
+	{
+		love::thread::Lock l(mutex);
+		quit = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+}
+
+void AsyncReader::add(ReadRequest *request)
+{
+	love::thread::Lock l(mutex);
+
+	for (int i = 0; i < (int) request->getPaths().size(); i++)
+		jobs.push({request, i, nextOrder++});
+
+	cond->broadcast();
+}
+
+void AsyncReader::workerLoop()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			love::thread::Lock l(mutex);
+
+			while (!quit && jobs.empty())
+				cond->wait(mutex);
+
+			if (quit)
+				return;
+
+			job = jobs.top();
+			jobs.pop();
+		}
+
+		ReadRequest *request = job.request;
+
+		if (request->isCancelled())
+		{
+			request->finish(job.index, nullptr, std::string());
+			continue;
+		}
+
+		StrongRef<FileData> data;
+		std::string error;
+
+		try
+		{
+			const std::string &path = request->getPaths()[job.index];
+			data.set(filesystem->read(path.c_str()), Acquire::NORETAIN);
+		}
+		catch (love::Exception &e)
+		{
+			error = e.what();
+		}
+
+		if (data.get() == nullptr && error.empty())
+			error = "File could not be read.";
+
+		request->finish(job.index, data, error);
+	}
+}
+
+} // filesystem
+} // love
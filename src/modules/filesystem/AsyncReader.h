@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_ASYNC_READER_H
+#define LOVE_FILESYSTEM_ASYNC_READER_H
+
+// LOVE
+#include "common/int.h"
+#include "thread/threads.h"
+#include "ReadRequest.h"
+
+// C++
+#include <queue>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+class Filesystem;
+
+/**
+ * A pool of threads which read the files of ReadRequests, highest priority
+ * first and in the order they were added otherwise.
+ **/
+class AsyncReader
+{
+public:
+
+	AsyncReader(Filesystem *filesystem);
+	~AsyncReader();
+
+	void add(ReadRequest *request);
+
+	static const int MAX_THREADS = 4;
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(AsyncReader *owner)
+			: owner(owner)
+		{
+			threadName = "AsyncReader";
+		}
+
+		void threadFunction() override
+		{
+			owner->workerLoop();
+		}
+
+	private:
+
+		AsyncReader *owner;
+	};
+
+	struct Job
+	{
+		StrongRef<ReadRequest> request;
+		int index;
+		uint64 order;
+	};
+
+	struct JobCompare
+	{
+		bool operator () (const Job &a, const Job &b) const
+		{
+			if (a.request->getPriority() != b.request->getPriority())
+				return a.request->getPriority() < b.request->getPriority();
+			return a.order > b.order;
+		}
+	};
+
+	void workerLoop();
+
+	Filesystem *filesystem;
+
+	std::vector<Worker *> workers;
+	std::priority_queue<Job, std::vector<Job>, JobCompare> jobs;
+	uint64 nextOrder;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+	bool quit;
+
+}; // AsyncReader
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_ASYNC_READER_H
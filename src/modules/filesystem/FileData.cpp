@@ -45,15 +45,15 @@ FileData::FileData(uint64 size, const std::string &filename)
 		throw love::Exception("Out of memory.");
 	}
 
-	size_t dotpos = filename.rfind('.');
+	parseFilename(filename);
+}
 
-	if (dotpos != std::string::npos)
-	{
-		extension = filename.substr(dotpos + 1);
-		name = filename.substr(0, dotpos);
-	}
-	else
-		name = filename;
+FileData::FileData(char *data, uint64 size, const std::string &filename)
+	: data(data)
+	, size(size)
+	, filename(filename)
+{
+	parseFilename(filename);
 }
 
 FileData::FileData(const FileData &c)
@@ -95,6 +95,19 @@ size_t FileData::getSize() const
 	return size > sizemax ? sizemax : (size_t) size;
 }
 
+void FileData::parseFilename(const std::string &filename)
+{
+	size_t dotpos = filename.rfind('.');
+
+	if (dotpos != std::string::npos)
+	{
+		extension = filename.substr(dotpos + 1);
+		name = filename.substr(0, dotpos);
+	}
+	else
+		name = filename;
+}
+
 const std::string &FileData::getFilename() const
 {
 	return filename;
@@ -53,7 +53,11 @@ class FileData : public Data
 	const std::string &getExtension() const;
 	const std::string &getName() const;
 
-private:
+protected:
+
+	// For subclasses which manage the memory themselves. The data must be set
+	// to null before the FileData destructor runs.
+	FileData(char *data, uint64 size, const std::string &filename);
 
 	// The actual data.
 	char *data;
@@ -61,6 +65,10 @@ class FileData : public Data
 	// Size of the data.
 	uint64 size;
 
+private:
+
+	void parseFilename(const std::string &filename);
+
 	// The filename used for error purposes.
 	std::string filename;
 
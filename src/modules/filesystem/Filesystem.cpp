@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Filesystem.h"
+#include "AsyncReader.h"
 #include "common/utf8.h"
 
 // Assume POSIX or Visual Studio.
@@ -45,11 +46,46 @@ namespace filesystem
 love::Type Filesystem::type("filesystem", &Module::type);
 
 Filesystem::Filesystem()
+	: asyncReader(nullptr)
 {
 }
 
 Filesystem::~Filesystem()
 {
+	stopAsyncReads();
+}
+
+FileData *Filesystem::map(const char *filename) const
+{
+	return read(filename);
+}
+
+ReadRequest *Filesystem::readAsync(const std::vector<std::string> &paths, int priority, love::thread::Channel *channel)
+{
+	// Pushing to a full lock-free Channel blocks until something is popped,
+	// which could stall the reading threads (and stopAsyncReads) forever.
+	if (channel != nullptr && channel->isLockFree())
+		throw love::Exception("readAsync can't push to a lock-free Channel.");
+
+	love::thread::Lock l(asyncReaderMutex);
+
+	// The threads are only started once something is read with them.
+	if (asyncReader == nullptr)
+		asyncReader = new AsyncReader(this);
+
+	ReadRequest *request = new ReadRequest(paths, priority, channel);
+	asyncReader->add(request);
+
+	return request;
+}
+
+void Filesystem::stopAsyncReads()
+{
+	love::thread::Lock l(asyncReaderMutex);
+
+	// Files which haven't been read yet are dropped along with the threads.
+	delete asyncReader;
+	asyncReader = nullptr;
 }
 
 void Filesystem::setAndroidSaveExternal(bool useExternal)
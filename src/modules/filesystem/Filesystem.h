@@ -26,8 +26,10 @@
 #include "common/Module.h"
 #include "common/int.h"
 #include "common/StringMap.h"
+#include "thread/threads.h"
 #include "FileData.h"
 #include "File.h"
+#include "ReadRequest.h"
 
 // C++
 #include <string>
@@ -58,6 +60,8 @@ namespace love
 namespace filesystem
 {
 
+class AsyncReader;
+
 class Filesystem : public Module
 {
 public:
@@ -211,6 +215,23 @@ class Filesystem : public Module
 	 **/
 	virtual FileData *read(const char *filename, int64 size = File::ALL) const = 0;
 
+	/**
+	 * Gets the contents of a whole file, memory-mapped instead of copied
+	 * where possible. Falls back to read() otherwise.
+	 * @param filename The name of the file to map.
+	 **/
+	virtual FileData *map(const char *filename) const;
+
+	/**
+	 * Reads whole files on background threads, higher priorities first. See
+	 * ReadRequest for how the results are delivered.
+	 * @param paths The names of the files to read.
+	 * @param priority The priority of the reads relative to other requests.
+	 * @param channel The Channel to push the results to, or null. Lock-free
+	 * Channels aren't allowed, since pushing to them can block.
+	 **/
+	virtual ReadRequest *readAsync(const std::vector<std::string> &paths, int priority, love::thread::Channel *channel);
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
@@ -267,8 +288,19 @@ class Filesystem : public Module
 	static bool getConstant(FileType in, const char *&out);
 	static std::vector<std::string> getConstants(FileType);
 
+protected:
+
+	/**
+	 * Stops the background reading threads. Implementations call this before
+	 * they're no longer able to read files.
+	 **/
+	void stopAsyncReads();
+
 private:
 
+	AsyncReader *asyncReader;
+	love::thread::MutexRef asyncReaderMutex;
+
 	// Should we save external or internal for Android
 	bool useExternal;
 
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "MappedFileData.h"
+#include "common/config.h"
+
+// C++
+#include <limits>
+
+#ifdef LOVE_WINDOWS
+#include "common/utf8.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+
+MappedFileData::MappedFileData(const std::string &nativepath, int64 offset, int64 size, const std::string &filename)
+	: FileData(nullptr, 0, filename)
+	, mapping(nullptr)
+	, mappingSize(0)
+{
+	if (offset < 0)
+		throw love::Exception("Invalid file offset.");
+
+#ifdef LOVE_WINDOWS
+	HANDLE file = CreateFileW(to_widestr(nativepath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw love::Exception("Could not open file %s.", nativepath.c_str());
+
+	LARGE_INTEGER filesize;
+	if (!GetFileSizeEx(file, &filesize))
+	{
+		CloseHandle(file);
+		throw love::Exception("Could not get the size of file %s.", nativepath.c_str());
+	}
+
+	int64 length = (int64) filesize.QuadPart;
+#else
+	int fd = open(nativepath.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw love::Exception("Could not open file %s.", nativepath.c_str());
+
+	struct stat buf;
+	if (fstat(fd, &buf) != 0 || !S_ISREG(buf.st_mode))
+	{
+		close(fd);
+		throw love::Exception("Could not get the size of file %s.", nativepath.c_str());
+	}
+
+	int64 length = (int64) buf.st_size;
+#endif
+
+	if (size < 0)
+		size = length - offset;
+
+	bool valid = offset <= length && size > 0 && size <= length - offset && (uint64) size <= (uint64) std::numeric_limits<size_t>::max();
+
+#ifdef LOVE_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int64 aligned = offset - offset % (int64) info.dwAllocationGranularity;
+
+	HANDLE filemapping = nullptr;
+	if (valid)
+		filemapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+	if (filemapping != nullptr)
+	{
+		mappingSize = (size_t) (size + (offset - aligned));
+		mapping = MapViewOfFile(filemapping, FILE_MAP_COPY, (DWORD) (aligned >> 32), (DWORD) (aligned & 0xFFFFFFFF), mappingSize);
+		CloseHandle(filemapping);
+	}
+
+	CloseHandle(file);
+#else
+	int64 aligned = offset - offset % (int64) sysconf(_SC_PAGESIZE);
+
+	if (valid)
+	{
+		mappingSize = (size_t) (size + (offset - aligned));
+		mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) aligned);
+
+		if (mapping == MAP_FAILED)
+			mapping = nullptr;
+	}
+
+	// The mapping keeps its own reference to the file.
+	close(fd);
+#endif
+
+	if (mapping == nullptr)
+		throw love::Exception("Could not map file %s into memory.", nativepath.c_str());
+
+	data = (char *) mapping + (offset - aligned);
+	this->size = (uint64) size;
+}
+
+MappedFileData::~MappedFileData()
+{
+#ifdef LOVE_WINDOWS
+	UnmapViewOfFile(mapping);
+#else
+	munmap(mapping, mappingSize);
+#endif
+
+	// Keep the FileData destructor from freeing the mapped memory.
+	data = nullptr;
+}
+
+} // filesystem
+} // love
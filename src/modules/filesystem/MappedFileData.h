@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_MAPPED_FILE_DATA_H
+#define LOVE_FILESYSTEM_MAPPED_FILE_DATA_H
+
+// LOVE
+#include "FileData.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * FileData whose contents are memory-mapped from part of a file on disk
+ * instead of being copied into memory.
+ *
+ * Pages are mapped copy-on-write, so writes to the data never reach the file.
+ * The file must not be truncated while it's mapped.
+ **/
+class MappedFileData : public FileData
+{
+public:
+
+	/**
+	 * Maps size bytes (or the rest of the file, if size is negative) starting
+	 * at offset into the file at the native path. Throws if the file can't be
+	 * mapped, including when the range is empty.
+	 **/
+	MappedFileData(const std::string &nativepath, int64 offset, int64 size, const std::string &filename);
+	virtual ~MappedFileData();
+
+private:
+
+	// The mapping starts at an aligned offset at or before the data.
+	void *mapping;
+	size_t mappingSize;
+
+}; // MappedFileData
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_MAPPED_FILE_DATA_H
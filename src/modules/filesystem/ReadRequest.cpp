@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ReadRequest.h"
+#include "common/Module.h"
+#include "event/Event.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+love::Type ReadRequest::type("ReadRequest", &Object::type);
+
+ReadRequest::ReadRequest(const std::vector<std::string> &paths, int priority, love::thread::Channel *channel)
+	: paths(paths)
+	, priority(priority)
+	, channel(channel)
+	, cancelled(false)
+	, completed(0)
+{
+}
+
+ReadRequest::~ReadRequest()
+{
+}
+
+const std::vector<std::string> &ReadRequest::getPaths() const
+{
+	return paths;
+}
+
+int ReadRequest::getPriority() const
+{
+	return priority;
+}
+
+love::thread::Channel *ReadRequest::getChannel() const
+{
+	return channel.get();
+}
+
+void ReadRequest::cancel()
+{
+	cancelled = true;
+}
+
+bool ReadRequest::isCancelled() const
+{
+	return cancelled;
+}
+
+int ReadRequest::getCompletedCount() const
+{
+	return completed;
+}
+
+bool ReadRequest::isComplete() const
+{
+	return completed == (int) paths.size();
+}
+
+void ReadRequest::finish(int index, FileData *data, const std::string &error)
+{
+	bool skipped = data == nullptr && error.empty();
+
+	if (channel.get() != nullptr)
+	{
+		// Results are pushed before they're counted, so everything is in the
+		// channel by the time isComplete() returns true. Order doesn't matter
+		// here, so the mutex isn't needed.
+		if (data != nullptr)
+			channel->push(Variant(&FileData::type, data));
+		else if (skipped)
+			channel->push(Variant("Could not read file " + paths[index] + ": the request was cancelled."));
+		else
+			channel->push(Variant(error));
+
+		++completed;
+		return;
+	}
+
+	// Event::push never blocks, so it's safe to hold the mutex while pushing.
+	love::thread::Lock l(mutex);
+
+	bool last = ++completed == (int) paths.size();
+
+	// Skipped files aren't reported, unless the callback needs to know the
+	// request is done.
+	if (skipped && !last)
+		return;
+
+	auto eventmodule = Module::getInstance<love::event::Event>(Module::M_EVENT);
+	if (eventmodule == nullptr)
+		return;
+
+	std::vector<Variant> vargs = {
+		Variant(&ReadRequest::type, this),
+		skipped ? Variant() : Variant(paths[index]),
+		data != nullptr ? Variant(&FileData::type, data) : Variant(),
+		error.empty() ? Variant() : Variant(error),
+		Variant(last),
+	};
+
+	StrongRef<love::event::Message> msg(new love::event::Message("filesystemread", vargs), Acquire::NORETAIN);
+	eventmodule->push(msg);
+}
+
+} // filesystem
+} // love
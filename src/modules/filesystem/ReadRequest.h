@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_FILESYSTEM_READ_REQUEST_H
+#define LOVE_FILESYSTEM_READ_REQUEST_H
+
+// LOVE
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "thread/Channel.h"
+#include "FileData.h"
+
+// C++
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * A group of files being read in the background by love.filesystem.readAsync.
+ *
+ * Each file is delivered when it has been read: pushed to the channel if the
+ * request has one, or otherwise sent as a "filesystemread" event. Channels
+ * get the FileData, or an error message if the file couldn't be read or was
+ * skipped. The event carries the request, the path, the FileData (or nil) and
+ * an error message (or nil), followed by a flag which is true for the
+ * request's last event.
+ **/
+class ReadRequest : public Object
+{
+public:
+
+	static love::Type type;
+
+	ReadRequest(const std::vector<std::string> &paths, int priority, love::thread::Channel *channel);
+	virtual ~ReadRequest();
+
+	const std::vector<std::string> &getPaths() const;
+	int getPriority() const;
+	love::thread::Channel *getChannel() const;
+
+	/**
+	 * Skips the files which haven't started being read yet. Skipped files are
+	 * pushed to the channel as errors, and aren't sent as events.
+	 **/
+	void cancel();
+	bool isCancelled() const;
+
+	/**
+	 * Gets the number of files which have been read, failed or been skipped.
+	 **/
+	int getCompletedCount() const;
+	bool isComplete() const;
+
+	/**
+	 * Delivers the result of reading a file. Called from the reading thread.
+	 * A null FileData and an empty error mean the file was skipped.
+	 **/
+	void finish(int index, FileData *data, const std::string &error);
+
+private:
+
+	std::vector<std::string> paths;
+	int priority;
+	StrongRef<love::thread::Channel> channel;
+
+	std::atomic<bool> cancelled;
+	std::atomic<int> completed;
+
+	// Keeps events from being sent out of order with the final one.
+	love::thread::MutexRef mutex;
+
+}; // ReadRequest
+
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_READ_REQUEST_H
@@ -27,6 +27,7 @@
 
 #include "Filesystem.h"
 #include "File.h"
+#include "filesystem/MappedFileData.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -89,6 +90,101 @@ namespace
 		return out.str();
 	}
 
+	love::uint16 readLE16(const love::uint8 *p)
+	{
+		return (love::uint16) (p[0] | (p[1] << 8));
+	}
+
+	love::uint32 readLE32(const love::uint8 *p)
+	{
+		return (love::uint32) p[0] | ((love::uint32) p[1] << 8) | ((love::uint32) p[2] << 16) | ((love::uint32) p[3] << 24);
+	}
+
+	// Finds where the data of an uncompressed (stored) zip entry lives in the
+	// archive file, so it can be mapped directly. Zip64 isn't supported.
+	bool findStoredZipEntry(const std::string &archive, const std::string &entry, love::int64 &offset, love::int64 &size)
+	{
+		using love::filesystem::MappedFileData;
+
+		// Only the pages which are looked at are actually read.
+		love::StrongRef<MappedFileData> zip(new MappedFileData(archive, 0, -1, archive), love::Acquire::NORETAIN);
+
+		const love::uint8 *bytes = (const love::uint8 *) zip->getData();
+		size_t length = zip->getSize();
+
+		const size_t EOCD_SIZE = 22;
+		const size_t CENTRAL_HEADER_SIZE = 46;
+		const size_t LOCAL_HEADER_SIZE = 30;
+
+		if (length < EOCD_SIZE)
+			return false;
+
+		// The end of central directory record can be followed by a comment of
+		// up to 64 KiB.
+		size_t eocd = length - EOCD_SIZE;
+		size_t searchend = eocd > 0xFFFF ? eocd - 0xFFFF : 0;
+
+		while (readLE32(bytes + eocd) != 0x06054b50)
+		{
+			if (eocd == searchend)
+				return false;
+			eocd--;
+		}
+
+		love::uint32 cdsize = readLE32(bytes + eocd + 12);
+		love::uint32 cdoffset = readLE32(bytes + eocd + 16);
+
+		if (cdoffset == 0xFFFFFFFF || cdsize > eocd || cdoffset > eocd - cdsize)
+			return false;
+
+		// Archives appended to another file (like a fused executable) have
+		// offsets relative to the start of the archive rather than the file.
+		size_t cdstart = eocd - cdsize;
+		size_t shift = cdstart - cdoffset;
+
+		size_t pos = cdstart;
+		while (pos + CENTRAL_HEADER_SIZE <= eocd && readLE32(bytes + pos) == 0x02014b50)
+		{
+			love::uint16 flags = readLE16(bytes + pos + 8);
+			love::uint16 method = readLE16(bytes + pos + 10);
+			love::uint32 compressedsize = readLE32(bytes + pos + 20);
+			love::uint32 uncompressedsize = readLE32(bytes + pos + 24);
+			love::uint16 namelen = readLE16(bytes + pos + 28);
+			love::uint16 extralen = readLE16(bytes + pos + 30);
+			love::uint16 commentlen = readLE16(bytes + pos + 32);
+			love::uint32 localoffset = readLE32(bytes + pos + 42);
+
+			if (pos + CENTRAL_HEADER_SIZE + namelen > eocd)
+				return false;
+
+			if (namelen == entry.size() && memcmp(bytes + pos + CENTRAL_HEADER_SIZE, entry.data(), namelen) == 0)
+			{
+				// Only unencrypted, uncompressed entries can be used as-is.
+				if (method != 0 || (flags & 1) != 0 || compressedsize != uncompressedsize)
+					return false;
+
+				if (compressedsize == 0xFFFFFFFF || localoffset == 0xFFFFFFFF)
+					return false;
+
+				size_t local = (size_t) localoffset + shift;
+				if (local > length - LOCAL_HEADER_SIZE || readLE32(bytes + local) != 0x04034b50)
+					return false;
+
+				size_t start = local + LOCAL_HEADER_SIZE + readLE16(bytes + local + 26) + readLE16(bytes + local + 28);
+				if (start > length || compressedsize > length - start)
+					return false;
+
+				offset = (love::int64) start;
+				size = (love::int64) compressedsize;
+				return true;
+			}
+
+			pos += CENTRAL_HEADER_SIZE + namelen + extralen + commentlen;
+		}
+
+		return false;
+	}
+
 }
 
 namespace love
@@ -112,6 +208,8 @@ Filesystem::~Filesystem()
 	love::android::deinitializeVirtualArchive();
 #endif
 
+	stopAsyncReads();
+
 	if (PHYSFS_isInit())
 		PHYSFS_deinit();
 }
@@ -652,6 +750,48 @@ FileData *Filesystem::read(const char *filename, int64 size) const
 	return file.read(size);
 }
 
+FileData *Filesystem::map(const char *filename) const
+{
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	const char *realdir = PHYSFS_getRealDir(filename);
+	Info info = {};
+
+	// Symlinks are left to read(), which knows whether they're allowed. Data
+	// mounted from memory has no file on disk.
+	if (realdir != nullptr && getInfo(filename, info) && info.type == FILETYPE_FILE && mountedData.count(realdir) == 0)
+	{
+		// Get the path relative to the directory or archive.
+		std::string path = filename;
+		std::string mountpoint = PHYSFS_getMountPoint(realdir);
+
+		path.erase(0, path.find_first_not_of('/'));
+		mountpoint.erase(0, mountpoint.find_first_not_of('/'));
+
+		if (!mountpoint.empty() && path.compare(0, mountpoint.size(), mountpoint) == 0)
+			path.erase(0, mountpoint.size());
+
+		try
+		{
+			if (isRealDirectory(realdir))
+				return new MappedFileData(std::string(realdir) + LOVE_PATH_SEPARATOR + path, 0, -1, filename);
+
+			int64 offset = 0;
+			int64 size = 0;
+
+			if (findStoredZipEntry(realdir, path, offset, size))
+				return new MappedFileData(realdir, offset, size, filename);
+		}
+		catch (love::Exception &)
+		{
+			// Fall back to copying the file.
+		}
+	}
+
+	return read(filename);
+}
+
 void Filesystem::write(const char *filename, const void *data, int64 size) const
 {
 	File file(filename);
@@ -24,8 +24,11 @@
 #include "wrap_File.h"
 #include "wrap_DroppedFile.h"
 #include "wrap_FileData.h"
+#include "wrap_ReadRequest.h"
 #include "data/wrap_Data.h"
 #include "data/wrap_DataModule.h"
+#include "thread/wrap_Channel.h"
+#include "event/Event.h"
 
 #include "physfs/Filesystem.h"
 
@@ -38,6 +41,11 @@
 #include <sstream>
 #include <algorithm>
 
+// Put the Lua code directly into a raw string literal.
+static const char filesystem_lua[] =
+#include "wrap_Filesystem.lua"
+;
+
 namespace love
 {
 namespace filesystem
@@ -503,6 +511,91 @@ int w_read(lua_State *L)
 	return 2;
 }
 
+int w_map(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	FileData *data = nullptr;
+	try
+	{
+		data = instance()->map(filename);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	if (data == nullptr)
+		return luax_ioError(L, "File could not be read.");
+
+	luax_pushtype(L, data);
+	data->release();
+	return 1;
+}
+
+int w_readAsync(lua_State *L)
+{
+	std::vector<std::string> paths;
+
+	if (lua_istable(L, 1))
+	{
+		for (int i = 1; i <= (int) luax_objlen(L, 1); i++)
+		{
+			lua_rawgeti(L, 1, i);
+			paths.push_back(luaL_checkstring(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+	else
+		paths.push_back(luaL_checkstring(L, 1));
+
+	// A request with no files would never send its final event.
+	if (paths.empty())
+		return luaL_argerror(L, 1, "at least one path is required");
+
+	int priority = 0;
+	love::thread::Channel *channel = nullptr;
+	bool hascallback = false;
+
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_getfield(L, 2, "priority");
+		priority = (int) luaL_optinteger(L, -1, 0);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "channel");
+		if (!lua_isnoneornil(L, -1))
+			channel = love::thread::luax_checkchannel(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, 2, "callback");
+		if (!lua_isnoneornil(L, -1))
+		{
+			luaL_checktype(L, -1, LUA_TFUNCTION);
+			hascallback = true;
+		}
+		lua_pop(L, 1);
+	}
+
+	if (channel != nullptr && hascallback)
+		return luaL_error(L, "Only one of a channel or a callback can be used.");
+	else if (channel == nullptr && !hascallback)
+		return luaL_error(L, "A channel or a callback is required.");
+
+	// Callbacks are run from love.event's "filesystemread" event.
+	if (hascallback && Module::getInstance<love::event::Event>(Module::M_EVENT) == nullptr)
+		return luaL_error(L, "love.event must be loaded to use readAsync callbacks.");
+
+	ReadRequest *request = nullptr;
+	luax_catchexcept(L, [&](){ request = instance()->readAsync(paths, priority, channel); });
+
+	luax_pushtype(L, request);
+	request->release();
+	return 1;
+}
+
 static int w_write_or_append(lua_State *L, File::Mode mode)
 {
 	const char *filename = luaL_checkstring(L, 1);
@@ -937,6 +1030,8 @@ static const luaL_Reg functions[] =
 	{ "createDirectory", w_createDirectory },
 	{ "remove", w_remove },
 	{ "read", w_read },
+	{ "map", w_map },
+	{ "_readAsync", w_readAsync },
 	{ "write", w_write },
 	{ "append", w_append },
 	{ "getDirectoryItems", w_getDirectoryItems },
@@ -967,6 +1062,7 @@ static const lua_CFunction types[] =
 	luaopen_file,
 	luaopen_droppedfile,
 	luaopen_filedata,
+	luaopen_readrequest,
 	0
 };
 
@@ -991,7 +1087,14 @@ extern "C" int luaopen_love_filesystem(lua_State *L)
 	w.functions = functions;
 	w.types = types;
 
-	return luax_register_module(L, w);
+	int n = luax_register_module(L, w);
+
+	// Execute wrap_Filesystem.lua, sending the filesystem table as an argument.
+	luaL_loadbuffer(L, filesystem_lua, sizeof(filesystem_lua), "wrap_Filesystem.lua");
+	lua_pushvalue(L, -2);
+	lua_call(L, 1, 0);
+
+	return n;
 }
 
 } // filesystem
@@ -0,0 +1,55 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2020 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+local filesystem = ...
+
+-- Callbacks of the readAsync requests which haven't finished yet.
+local readcallbacks = {}
+
+function filesystem.readAsync(paths, options)
+	local request = filesystem._readAsync(paths, options)
+
+	if options and options.callback then
+		readcallbacks[request] = options.callback
+	end
+
+	return request
+end
+
+-- Called by the "filesystemread" event handler. The path is nil when the last
+-- event only marks the end of a cancelled request.
+function filesystem._dispatchRead(request, path, data, err, last)
+	local callback = readcallbacks[request]
+
+	if last then
+		readcallbacks[request] = nil
+	end
+
+	if callback and path then
+		return callback(path, data, err)
+	end
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
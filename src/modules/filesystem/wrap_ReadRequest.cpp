@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ReadRequest.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+ReadRequest *luax_checkreadrequest(lua_State *L, int idx)
+{
+	return luax_checktype<ReadRequest>(L, idx);
+}
+
+int w_ReadRequest_cancel(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	t->cancel();
+	return 0;
+}
+
+int w_ReadRequest_isCancelled(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	luax_pushboolean(L, t->isCancelled());
+	return 1;
+}
+
+int w_ReadRequest_isComplete(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	luax_pushboolean(L, t->isComplete());
+	return 1;
+}
+
+int w_ReadRequest_getProgress(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	lua_pushinteger(L, t->getCompletedCount());
+	lua_pushinteger(L, (lua_Integer) t->getPaths().size());
+	return 2;
+}
+
+int w_ReadRequest_getPaths(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	const std::vector<std::string> &paths = t->getPaths();
+
+	lua_createtable(L, (int) paths.size(), 0);
+
+	for (int i = 0; i < (int) paths.size(); i++)
+	{
+		luax_pushstring(L, paths[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_ReadRequest_getPriority(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_ReadRequest_getChannel(lua_State *L)
+{
+	ReadRequest *t = luax_checkreadrequest(L, 1);
+	luax_pushtype(L, t->getChannel());
+	return 1;
+}
+
+static const luaL_Reg w_ReadRequest_functions[] =
+{
+	{ "cancel", w_ReadRequest_cancel },
+	{ "isCancelled", w_ReadRequest_isCancelled },
+	{ "isComplete", w_ReadRequest_isComplete },
+	{ "getProgress", w_ReadRequest_getProgress },
+	{ "getPaths", w_ReadRequest_getPaths },
+	{ "getPriority", w_ReadRequest_getPriority },
+	{ "getChannel", w_ReadRequest_getChannel },
+
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_readrequest(lua_State *L)
+{
+	return luax_register_type(L, &ReadRequest::type, w_ReadRequest_functions, nullptr);
+}
+
+} // filesystem
+} // love
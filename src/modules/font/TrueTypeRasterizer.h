@@ -46,6 +46,18 @@ class TrueTypeRasterizer : public Rasterizer
 
 	virtual ~TrueTypeRasterizer() {}
 
+	/**
+	 * Creates a copy of this Rasterizer with its own font face, which can be
+	 * used on another thread while this one is in use.
+	 **/
+	virtual TrueTypeRasterizer *newThreadCopy() const = 0;
+
+	/**
+	 * Gets a hash of the font data and the settings which affect the glyphs
+	 * this Rasterizer produces, for caching rasterized glyphs.
+	 **/
+	virtual uint64 getCacheKey() const = 0;
+
 	static bool getConstant(const char *in, Hinting &out);
 	static bool getConstant(Hinting in, const char *&out);
 	static std::vector<std::string> getConstants(Hinting);
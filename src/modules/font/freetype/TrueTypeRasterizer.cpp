@@ -21,6 +21,7 @@
 // LOVE
 #include "TrueTypeRasterizer.h"
 #include "common/Exception.h"
+#include "libraries/xxHash/xxhash.h"
 
 // C
 #include <math.h>
@@ -34,7 +35,9 @@ namespace freetype
 
 TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting)
 	: data(data)
+	, size(size)
 	, hinting(hinting)
+	, ownLibrary(nullptr)
 {
 	this->dpiScale = dpiscale;
 	size = floorf(size * dpiscale + 0.5f);
@@ -68,6 +71,47 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 TrueTypeRasterizer::~TrueTypeRasterizer()
 {
 	FT_Done_Face(face);
+
+	if (ownLibrary != nullptr)
+		FT_Done_FreeType(ownLibrary);
+}
+
+love::font::TrueTypeRasterizer *TrueTypeRasterizer::newThreadCopy() const
+{
+	// FreeType libraries and their faces can't be used from multiple threads
+	// at once, so the copy gets a library of its own.
+	FT_Library library = nullptr;
+	if (FT_Init_FreeType(&library))
+		throw love::Exception("TrueType Font loading error: FT_Init_FreeType failed");
+
+	TrueTypeRasterizer *r = nullptr;
+
+	try
+	{
+		r = new TrueTypeRasterizer(library, data, size, dpiScale, hinting);
+	}
+	catch (love::Exception &)
+	{
+		FT_Done_FreeType(library);
+		throw;
+	}
+
+	r->ownLibrary = library;
+	return r;
+}
+
+uint64 TrueTypeRasterizer::getCacheKey() const
+{
+	uint64 key = XXH64(data->getData(), data->getSize(), 0);
+
+	struct
+	{
+		int32 size;
+		float dpiScale;
+		int32 hinting;
+	} settings = {size, dpiScale, (int32) hinting};
+
+	return XXH64(&settings, sizeof(settings), key);
 }
 
 int TrueTypeRasterizer::getLineHeight() const
@@ -55,6 +55,10 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
 
+	// Implement love::font::TrueTypeRasterizer
+	love::font::TrueTypeRasterizer *newThreadCopy() const override;
+	uint64 getCacheKey() const override;
+
 	static bool accepts(FT_Library library, love::Data *data);
 
 private:
@@ -67,8 +71,14 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 	// Font data
 	StrongRef<love::Data> data;
 
+	// The requested size, before the DPI scale is applied.
+	int size;
+
 	Hinting hinting;
 
+	// Only set for copies made by newThreadCopy, which need their own.
+	FT_Library ownLibrary;
+
 }; // TrueTypeRasterizer
 
 } // freetype
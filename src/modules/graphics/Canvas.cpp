@@ -118,7 +118,7 @@ int Canvas::getRequestedMSAA() const
 	return settings.msaa;
 }
 
-love::image::ImageData *Canvas::newImageData(love::image::Image *module, int slice, int mipmap, const Rect &r)
+PixelFormat Canvas::validateReadback(int slice, int mipmap, const Rect &r)
 {
 	if (!isReadable())
 		throw love::Exception("Canvas:newImageData cannot be called on non-readable Canvases.");
@@ -151,6 +151,12 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 		throw love::Exception("ImageData with the '%s' pixel format is not supported.", formatname);
 	}
 
+	return dataformat;
+}
+
+love::image::ImageData *Canvas::newImageData(love::image::Image *module, int slice, int mipmap, const Rect &r)
+{
+	PixelFormat dataformat = validateReadback(slice, mipmap, r);
 	return module->newImageData(r.w, r.h, dataformat);
 }
 
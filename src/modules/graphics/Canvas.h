@@ -81,6 +81,12 @@ class Canvas : public Texture
 	int getRequestedMSAA() const;
 
 	virtual love::image::ImageData *newImageData(love::image::Image *module, int slice, int mipmap, const Rect &rect);
+
+	/**
+	 * Throws if the given region can't be read back, otherwise returns the
+	 * pixel format of the ImageData it would be read into.
+	 **/
+	PixelFormat validateReadback(int slice, int mipmap, const Rect &rect);
 	virtual void generateMipmaps() = 0;
 
 	virtual int getMSAA() const = 0;
@@ -25,12 +25,16 @@
 
 #include "common/math.h"
 #include "common/Matrix.h"
+#include "filesystem/Filesystem.h"
+#include "font/TrueTypeRasterizer.h"
+#include "libraries/xxHash/xxhash.h"
 #include "Graphics.h"
 
 #include <math.h>
 #include <sstream>
 #include <algorithm> // for max
 #include <limits>
+#include <stdio.h>
 
 namespace love
 {
@@ -42,8 +46,65 @@ static inline uint16 normToUint16(double n)
 	return (uint16) (n * LOVE_UINT16_MAX);
 }
 
+namespace
+{
+
+const char GLYPH_CACHE_MAGIC[8] = {'L', 'O', 'V', 'E', 'G', 'L', 'Y', 'F'};
+
+// Glyph cache files are read and written by the same platform, so they
+// use native byte order and layout.
+struct GlyphCacheHeader
+{
+	char magic[8];
+	uint32 version;
+	int32 pixelFormat;
+	uint64 key;
+	int32 textureWidth;
+	int32 textureHeight;
+	uint32 glyphCount;
+	uint32 kerningCount;
+	uint32 skylineCount;
+	uint32 reserved;
+};
+
+struct GlyphCacheEntry
+{
+	uint32 glyph;
+	int32 spacing;
+	int32 textureX;
+	int32 textureY;
+	int32 width;
+	int32 height;
+	float x[4];
+	float y[4];
+};
+
+struct KerningCacheEntry
+{
+	uint64 glyphs;
+	float kerning;
+	uint32 reserved;
+};
+
+std::string getGlyphCachePath(uint64 key)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "fontcache/%016llx", (unsigned long long) key);
+	return path;
+}
+
+template <typename T>
+void appendCacheData(std::vector<uint8> &data, const T &value)
+{
+	const uint8 *bytes = (const uint8 *) &value;
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+} // anonymous namespace
+
 love::Type Font::type("Font", &Object::type);
 int Font::fontCount = 0;
+bool Font::glyphCacheEnabled = false;
 
 const vertex::CommonFormat Font::vertexFormat = vertex::CommonFormat::XYf_STus_RGBAub;
 
@@ -55,8 +116,14 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 	, textureHeight(128)
 	, filter(f)
 	, dpiScale(r->getDPIScale())
+	, packer(0, 0)
+	, dirtyRowStart(0)
+	, dirtyRowEnd(0)
 	, useSpacesAsTab(false)
 	, textureCacheID(0)
+	, layoutCacheSize(DEFAULT_LAYOUT_CACHE_SIZE)
+	, layoutCacheHits(0)
+	, layoutCacheMisses(0)
 {
 	filter.mipmap = Texture::FILTER_NONE;
 
@@ -89,6 +156,9 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 
 Font::~Font()
 {
+	for (const auto &task : preloadTasks)
+		task->cancel();
+
 	--fontCount;
 }
 
@@ -124,7 +194,11 @@ bool Font::loadVolatile()
 	textureCacheID++;
 	glyphs.clear();
 	images.clear();
-	createTexture();
+	texturePixels.clear();
+
+	if (!loadGlyphCache())
+		createTexture();
+
 	return true;
 }
 
@@ -136,69 +210,388 @@ void Font::createTexture()
 	Image *image = nullptr;
 	TextureSize size = {textureWidth, textureHeight};
 	TextureSize nextsize = getNextTextureSize();
-	bool recreatetexture = false;
+	bool growtexture = false;
 
 	// If we have an existing texture already, we'll try replacing it with a
 	// larger-sized one rather than creating a second one. Having a single
 	// texture reduces texture switches and draw calls when rendering.
 	if ((nextsize.width > size.width || nextsize.height > size.height) && !images.empty())
 	{
-		recreatetexture = true;
+		growtexture = true;
 		size = nextsize;
+	}
+	else if (!images.empty())
+	{
+		// The full texture is kept, so it needs its staged glyphs first.
+		uploadGlyphs();
+	}
+
+	size_t bpp = getPixelFormatSize(pixelFormat);
+	size_t pixelcount = (size_t) size.width * size.height;
+
+	// Initialize the texture with transparent white for Luminance-Alpha
+	// formats (since we keep luminance constant and vary alpha in those
+	// glyphs), and transparent black otherwise.
+	std::vector<uint8> pixels(pixelcount * bpp, 0);
+
+	if (pixelFormat == PIXELFORMAT_LA8)
+	{
+		for (size_t i = 0; i < pixelcount; i++)
+			pixels[i * 2 + 0] = 255;
+	}
+
+	// Copy the old glyphs to the same place in the larger texture, rather
+	// than rasterizing them again.
+	if (growtexture)
+	{
+		size_t oldrowsize = textureWidth * bpp;
+		size_t newrowsize = size.width * bpp;
+
+		for (int y = 0; y < textureHeight; y++)
+			memcpy(&pixels[y * newrowsize], &texturePixels[y * oldrowsize], oldrowsize);
+	}
+
+	image = newTexture(size.width, size.height, pixels);
+
+	texturePixels = std::move(pixels);
+	dirtyRowStart = dirtyRowEnd = 0;
+
+	textureWidth  = size.width;
+	textureHeight = size.height;
+
+	if (growtexture)
+	{
+		textureCacheID++;
+
+		// Point the glyphs of the replaced texture at the new one, and update
+		// their texture coordinates for its size.
+		Texture *oldtexture = images.back();
+
+		for (auto &glyphpair : glyphs)
+		{
+			Glyph &g = glyphpair.second;
+			if (g.texture == oldtexture)
+			{
+				g.texture = image;
+				setGlyphTexCoords(g);
+			}
+		}
+
 		images.pop_back();
+		packer.grow(size.width - TEXTURE_PADDING, size.height - TEXTURE_PADDING);
 	}
+	else
+		packer.reset(size.width - TEXTURE_PADDING, size.height - TEXTURE_PADDING);
+
+	images.emplace_back(image, Acquire::NORETAIN);
+}
+
+Image *Font::newTexture(int width, int height, const std::vector<uint8> &pixels)
+{
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 
 	Image::Settings settings;
-	image = gfx->newImage(TEXTURE_2D, pixelFormat, size.width, size.height, 1, settings);
+	Image *image = gfx->newImage(TEXTURE_2D, pixelFormat, width, height, 1, settings);
 	image->setFilter(filter);
 
+	Rect rect = {0, 0, width, height};
+	image->replacePixels(pixels.data(), pixels.size(), 0, 0, rect, false);
+
+	return image;
+}
+
+void Font::uploadGlyphs()
+{
+	if (dirtyRowStart >= dirtyRowEnd || images.empty())
+		return;
+
+	// Full rows are uploaded, since they're contiguous in texturePixels.
+	size_t rowsize = getPixelFormatSize(pixelFormat) * textureWidth;
+	Rect rect = {0, dirtyRowStart, textureWidth, dirtyRowEnd - dirtyRowStart};
+
+	dirtyRowStart = dirtyRowEnd = 0;
+
+	images.back()->replacePixels(&texturePixels[rowsize * rect.y], rowsize * rect.h, 0, 0, rect, false);
+}
+
+void Font::unloadVolatile()
+{
+	glyphs.clear();
+	images.clear();
+	texturePixels.clear();
+	dirtyRowStart = dirtyRowEnd = 0;
+	clearLayoutCache();
+}
+
+uint64 Font::getGlyphCacheKey() const
+{
+	uint64 key = GLYPH_CACHE_VERSION;
+
+	for (const StrongRef<love::font::Rasterizer> &r : rasterizers)
 	{
-		size_t bpp = getPixelFormatSize(pixelFormat);
-		size_t pixelcount = size.width * size.height;
+		if (r->getDataType() != love::font::Rasterizer::DATA_TRUETYPE)
+			return 0;
+
+		uint64 rasterizerkey = ((love::font::TrueTypeRasterizer *) r.get())->getCacheKey();
+		key = XXH64(&rasterizerkey, sizeof(rasterizerkey), key);
+	}
+
+	// Glyph placement in the texture also depends on these.
+	int32 settings[] = {(int32) pixelFormat, TEXTURE_PADDING, useSpacesAsTab ? SPACES_PER_TAB : 0};
+	return XXH64(settings, sizeof(settings), key);
+}
+
+bool Font::loadGlyphCache()
+{
+	if (!glyphCacheEnabled)
+		return false;
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (fs == nullptr || gfx == nullptr)
+		return false;
+
+	uint64 key = getGlyphCacheKey();
+	if (key == 0)
+		return false;
+
+	std::string path = getGlyphCachePath(key);
+
+	filesystem::Filesystem::Info info = {};
+	if (!fs->getInfo(path.c_str(), info) || info.type != filesystem::Filesystem::FILETYPE_FILE)
+		return false;
+
+	// A cache file which can't be read or doesn't match is ignored, and the
+	// glyphs are rasterized as usual.
+	StrongRef<filesystem::FileData> filedata;
+	try
+	{
+		filedata.set(fs->read(path.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	const uint8 *data = (const uint8 *) filedata->getData();
+	size_t remaining = filedata->getSize();
+
+	auto read = [&](void *dst, size_t size) -> bool
+	{
+		if (size > remaining)
+			return false;
+
+		memcpy(dst, data, size);
+		data += size;
+		remaining -= size;
+		return true;
+	};
+
+	GlyphCacheHeader header;
+	if (!read(&header, sizeof(GlyphCacheHeader))
+		|| memcmp(header.magic, GLYPH_CACHE_MAGIC, sizeof(GLYPH_CACHE_MAGIC)) != 0
+		|| header.version != GLYPH_CACHE_VERSION
+		|| header.key != key
+		|| header.pixelFormat != (int32) pixelFormat)
+	{
+		return false;
+	}
+
+	int maxsize = (int) gfx->getCapabilities().limits[Graphics::LIMIT_TEXTURE_SIZE];
+	if (header.textureWidth <= TEXTURE_PADDING || header.textureHeight <= TEXTURE_PADDING
+		|| header.textureWidth > maxsize || header.textureHeight > maxsize)
+	{
+		return false;
+	}
 
-		// Initialize the texture with transparent white for Luminance-Alpha
-		// formats (since we keep luminance constant and vary alpha in those
-		// glyphs), and transparent black otherwise.
-		std::vector<uint8> emptydata(pixelcount * bpp, 0);
+	// Check the counts against the file's size before allocating anything
+	// for them.
+	uint64 tablesize = (uint64) header.glyphCount * sizeof(GlyphCacheEntry)
+		+ (uint64) header.kerningCount * sizeof(KerningCacheEntry)
+		+ (uint64) header.skylineCount * sizeof(SkylinePacker::Node);
 
-		if (pixelFormat == PIXELFORMAT_LA8)
+	if (tablesize > remaining)
+		return false;
+
+	std::unordered_map<uint32, Glyph> newglyphs;
+	newglyphs.reserve(header.glyphCount);
+
+	for (uint32 i = 0; i < header.glyphCount; i++)
+	{
+		GlyphCacheEntry entry;
+		if (!read(&entry, sizeof(GlyphCacheEntry)))
+			return false;
+
+		if (entry.width < 0 || entry.height < 0 || entry.textureX < 0 || entry.textureY < 0
+			|| entry.width > header.textureWidth - entry.textureX
+			|| entry.height > header.textureHeight - entry.textureY)
+		{
+			return false;
+		}
+
+		Glyph g;
+		g.texture = nullptr;
+		g.spacing = entry.spacing;
+		g.textureX = entry.textureX;
+		g.textureY = entry.textureY;
+		g.width = entry.width;
+		g.height = entry.height;
+
+		memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
+
+		for (int v = 0; v < 4; v++)
 		{
-			for (size_t i = 0; i < pixelcount; i++)
-				emptydata[i * 2 + 0] = 255;
+			g.vertices[v].x = entry.x[v];
+			g.vertices[v].y = entry.y[v];
+			g.vertices[v].color = Color32(255, 255, 255, 255);
 		}
 
-		Rect rect = {0, 0, size.width, size.height};
-		image->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
+		newglyphs[entry.glyph] = g;
 	}
 
+	std::unordered_map<uint64, float> newkerning;
+	newkerning.reserve(header.kerningCount);
+
+	for (uint32 i = 0; i < header.kerningCount; i++)
+	{
+		KerningCacheEntry entry;
+		if (!read(&entry, sizeof(KerningCacheEntry)))
+			return false;
+
+		newkerning[entry.glyphs] = entry.kerning;
+	}
+
+	std::vector<SkylinePacker::Node> skyline(header.skylineCount);
+	if (!read(skyline.data(), sizeof(SkylinePacker::Node) * skyline.size()))
+		return false;
+
+	size_t pixelsize = (size_t) header.textureWidth * header.textureHeight * getPixelFormatSize(pixelFormat);
+	if (remaining != pixelsize)
+		return false;
+
+	if (!packer.setSkyline(header.textureWidth - TEXTURE_PADDING, header.textureHeight - TEXTURE_PADDING, skyline))
+		return false;
+
+	gfx->flushStreamDraws();
+
+	// The pixels are kept so the texture can still grow when glyphs which
+	// weren't cached are added.
+	std::vector<uint8> pixels(data, data + pixelsize);
+	Image *image = newTexture(header.textureWidth, header.textureHeight, pixels);
+
+	images.clear();
 	images.emplace_back(image, Acquire::NORETAIN);
 
-	textureWidth  = size.width;
-	textureHeight = size.height;
+	texturePixels = std::move(pixels);
+	dirtyRowStart = dirtyRowEnd = 0;
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	textureWidth  = header.textureWidth;
+	textureHeight = header.textureHeight;
 
-	// Re-add the old glyphs if we re-created the existing texture object.
-	if (recreatetexture)
+	for (auto &glyphpair : newglyphs)
 	{
-		textureCacheID++;
+		Glyph &g = glyphpair.second;
+		if (g.width > 0 && g.height > 0)
+		{
+			g.texture = image;
+			setGlyphTexCoords(g);
+		}
+	}
 
-		std::vector<uint32> glyphstoadd;
+	glyphs = std::move(newglyphs);
+	kerning = std::move(newkerning);
+	textureCacheID++;
 
-		for (const auto &glyphpair : glyphs)
-			glyphstoadd.push_back(glyphpair.first);
+	return true;
+}
 
-		glyphs.clear();
-		
-		for (uint32 g : glyphstoadd)
-			addGlyph(g);
+void Font::saveGlyphCache()
+{
+	uint64 key = getGlyphCacheKey();
+	if (key == 0)
+		throw love::Exception("Only TrueType fonts can save a glyph cache.");
+
+	// Glyphs from finished preloads should be part of the cache too.
+	if (!preloadTasks.empty())
+		addPreloadedGlyphs();
+
+	if (images.size() != 1)
+		throw love::Exception("Cannot save the glyph cache of a font with more than one glyph texture.");
+
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr)
+		throw love::Exception("The love.filesystem module must be loaded to save a glyph cache.");
+
+	const std::vector<SkylinePacker::Node> &skyline = packer.getSkyline();
+	size_t bpp = getPixelFormatSize(pixelFormat);
+
+	std::vector<uint8> data;
+	data.reserve(sizeof(GlyphCacheHeader) + glyphs.size() * sizeof(GlyphCacheEntry)
+				 + kerning.size() * sizeof(KerningCacheEntry)
+				 + skyline.size() * sizeof(SkylinePacker::Node)
+				 + texturePixels.size());
+
+	GlyphCacheHeader header = {};
+	memcpy(header.magic, GLYPH_CACHE_MAGIC, sizeof(GLYPH_CACHE_MAGIC));
+	header.version = GLYPH_CACHE_VERSION;
+	header.pixelFormat = (int32) pixelFormat;
+	header.key = key;
+	header.textureWidth = textureWidth;
+	header.textureHeight = textureHeight;
+	header.glyphCount = (uint32) glyphs.size();
+	header.kerningCount = (uint32) kerning.size();
+	header.skylineCount = (uint32) skyline.size();
+
+	appendCacheData(data, header);
+
+	for (const auto &glyphpair : glyphs)
+	{
+		const Glyph &g = glyphpair.second;
+
+		GlyphCacheEntry entry = {};
+		entry.glyph = glyphpair.first;
+		entry.spacing = g.spacing;
+		entry.textureX = g.textureX;
+		entry.textureY = g.textureY;
+		entry.width = g.width;
+		entry.height = g.height;
+
+		for (int v = 0; v < 4; v++)
+		{
+			entry.x[v] = g.vertices[v].x;
+			entry.y[v] = g.vertices[v].y;
+		}
+
+		appendCacheData(data, entry);
 	}
+
+	for (const auto &kerningpair : kerning)
+	{
+		KerningCacheEntry entry = {};
+		entry.glyphs = kerningpair.first;
+		entry.kerning = kerningpair.second;
+		appendCacheData(data, entry);
+	}
+
+	for (const SkylinePacker::Node &node : skyline)
+		appendCacheData(data, node);
+
+	data.insert(data.end(), texturePixels.begin(), texturePixels.begin() + (size_t) textureWidth * textureHeight * bpp);
+
+	std::string path = getGlyphCachePath(key);
+
+	fs->createDirectory("fontcache");
+	fs->write(path.c_str(), data.data(), (int64) data.size());
 }
 
-void Font::unloadVolatile()
+void Font::setGlyphCacheEnabled(bool enable)
 {
-	glyphs.clear();
-	images.clear();
+	glyphCacheEnabled = enable;
+}
+
+bool Font::isGlyphCacheEnabled()
+{
+	return glyphCacheEnabled;
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
@@ -231,49 +624,71 @@ love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
 const Font::Glyph &Font::addGlyph(uint32 glyph)
 {
 	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyph), Acquire::NORETAIN);
+	return addGlyph(glyph, gd);
+}
 
+const Font::Glyph &Font::addGlyph(uint32 glyph, love::font::GlyphData *gd)
+{
 	int w = gd->getWidth();
 	int h = gd->getHeight();
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
-	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
-		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
-		}
-
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
-		{
-			// Totally out of space - new texture!
-			createTexture();
-
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyph);
-		}
-	}
-
 	Glyph g;
 
 	g.texture = 0;
 	g.spacing = floorf(gd->getAdvance() / dpiScale + 0.5f);
+	g.textureX = g.textureY = 0;
+	g.width = w;
+	g.height = h;
 
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
 
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Image *image = images.back();
-		g.texture = image;
+		if (gd->getFormat() != pixelFormat)
+			throw love::Exception("Font glyphs must all use the same pixel format.");
+
+		int x = 0;
+		int y = 0;
+
+		while (!packer.pack(w + TEXTURE_PADDING, h + TEXTURE_PADDING, x, y))
+		{
+			TextureSize nextsize = getNextTextureSize();
+			bool cangrow = nextsize.width > textureWidth || nextsize.height > textureHeight;
+
+			if (packer.isEmpty() && !cangrow)
+				throw love::Exception("Font glyph %u is too large to fit in a texture.", glyph);
+
+			// Out of space - grow the texture, or start a new one.
+			createTexture();
+		}
 
-		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
-		image->replacePixels(gd->getData(), gd->getSize(), 0, 0, rect, false);
+		x += TEXTURE_PADDING;
+		y += TEXTURE_PADDING;
 
-		double tX     = (double) textureX,     tY      = (double) textureY;
-		double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+		// Stage the glyph's pixels. They're sent to the texture in a batch
+		// with other new glyphs, by uploadGlyphs.
+		size_t bpp = getPixelFormatSize(pixelFormat);
+		size_t rowsize = w * bpp;
+		const uint8 *src = (const uint8 *) gd->getData();
+
+		for (int row = 0; row < h; row++)
+			memcpy(&texturePixels[((y + row) * textureWidth + x) * bpp], src + row * rowsize, rowsize);
+
+		if (dirtyRowStart >= dirtyRowEnd)
+		{
+			dirtyRowStart = y;
+			dirtyRowEnd = y + h;
+		}
+		else
+		{
+			dirtyRowStart = std::min(dirtyRowStart, y);
+			dirtyRowEnd = std::max(dirtyRowEnd, y + h);
+		}
+
+		g.texture = images.back();
+		g.textureX = x;
+		g.textureY = y;
 
 		Color32 c(255, 255, 255, 255);
 
@@ -287,10 +702,10 @@ const Font::Glyph &Font::addGlyph(uint32 glyph)
 		// 1---3
 		const GlyphVertex verts[4] =
 		{
-			{float(-o),      float(-o),      normToUint16((tX-o)/tWidth),   normToUint16((tY-o)/tHeight),   c},
-			{float(-o),      (h+o)/dpiScale, normToUint16((tX-o)/tWidth),   normToUint16((tY+h+o)/tHeight), c},
-			{(w+o)/dpiScale, float(-o),      normToUint16((tX+w+o)/tWidth), normToUint16((tY-o)/tHeight),   c},
-			{(w+o)/dpiScale, (h+o)/dpiScale, normToUint16((tX+w+o)/tWidth), normToUint16((tY+h+o)/tHeight), c}
+			{float(-o),      float(-o),      0, 0, c},
+			{float(-o),      (h+o)/dpiScale, 0, 0, c},
+			{(w+o)/dpiScale, float(-o),      0, 0, c},
+			{(w+o)/dpiScale, (h+o)/dpiScale, 0, 0, c}
 		};
 
 		// Copy vertex data to the glyph and set proper bearing.
@@ -301,14 +716,32 @@ const Font::Glyph &Font::addGlyph(uint32 glyph)
 			g.vertices[i].y -= gd->getBearingY() / dpiScale;
 		}
 
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
+		setGlyphTexCoords(g);
 	}
 
 	glyphs[glyph] = g;
 	return glyphs[glyph];
 }
 
+void Font::setGlyphTexCoords(Glyph &g) const
+{
+	double tX     = (double) g.textureX,   tY      = (double) g.textureY;
+	double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+	double w = (double) g.width, h = (double) g.height;
+
+	// Includes the 1 pixel quad extrusion done in addGlyph.
+	int o = 1;
+
+	g.vertices[0].s = normToUint16((tX-o)/tWidth);
+	g.vertices[0].t = normToUint16((tY-o)/tHeight);
+	g.vertices[1].s = normToUint16((tX-o)/tWidth);
+	g.vertices[1].t = normToUint16((tY+h+o)/tHeight);
+	g.vertices[2].s = normToUint16((tX+w+o)/tWidth);
+	g.vertices[2].t = normToUint16((tY-o)/tHeight);
+	g.vertices[3].s = normToUint16((tX+w+o)/tWidth);
+	g.vertices[3].t = normToUint16((tY+h+o)/tHeight);
+}
+
 const Font::Glyph &Font::findGlyph(uint32 glyph)
 {
 	const auto it = glyphs.find(glyph);
@@ -316,9 +749,94 @@ const Font::Glyph &Font::findGlyph(uint32 glyph)
 	if (it != glyphs.end())
 		return it->second;
 
+	// The glyph may have been rasterized by a preload already.
+	if (!preloadTasks.empty())
+	{
+		addPreloadedGlyphs();
+
+		const auto preloadedit = glyphs.find(glyph);
+		if (preloadedit != glyphs.end())
+			return preloadedit->second;
+	}
+
 	return addGlyph(glyph);
 }
 
+void Font::addPreloadedGlyphs()
+{
+	std::vector<StrongRef<love::font::GlyphData>> preloaded;
+
+	for (auto it = preloadTasks.begin(); it != preloadTasks.end();)
+	{
+		// A task which was complete before its glyphs were taken has none
+		// left afterwards.
+		bool complete = (*it)->isComplete();
+		(*it)->takeGlyphs(preloaded);
+
+		if (complete)
+			it = preloadTasks.erase(it);
+		else
+			++it;
+	}
+
+	for (const auto &gd : preloaded)
+	{
+		uint32 g = gd->getGlyph();
+		if (glyphs.find(g) == glyphs.end())
+			addGlyph(g, gd);
+	}
+}
+
+void Font::preload(const Codepoints &codepoints, bool async)
+{
+	addPreloadedGlyphs();
+
+	if (async && rasterizers[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
+	{
+		std::vector<uint32> missing;
+
+		for (uint32 g : codepoints)
+		{
+			// Tabs made of spaces don't need to be rasterized.
+			if (g == 9 && useSpacesAsTab)
+				findGlyph(g);
+			else if (glyphs.find(g) == glyphs.end())
+				missing.push_back(g);
+		}
+
+		std::sort(missing.begin(), missing.end());
+		missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+		if (!missing.empty())
+		{
+			StrongRef<GlyphPreloadTask> task(new GlyphPreloadTask(rasterizers, missing), Acquire::NORETAIN);
+
+			if (!task->start())
+				throw love::Exception("Could not start a thread to preload glyphs.");
+
+			preloadTasks.push_back(task);
+		}
+	}
+	else
+	{
+		for (uint32 g : codepoints)
+			findGlyph(g);
+	}
+
+	uploadGlyphs();
+}
+
+bool Font::isPreloading() const
+{
+	for (const auto &task : preloadTasks)
+	{
+		if (!task->isComplete())
+			return true;
+	}
+
+	return false;
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
 	uint64 packedglyphs = ((uint64) leftglyph << 32) | (uint64) rightglyph;
@@ -529,6 +1047,9 @@ std::vector<Font::DrawCommand> Font::generateVertices(const ColoredCodepoints &c
 
 	std::sort(commands.begin(), commands.end(), drawsort);
 
+	// Send any glyphs added above to the texture, before they're drawn.
+	uploadGlyphs();
+
 	if (dx > maxwidth)
 		maxwidth = (int) dx;
 
@@ -654,8 +1175,124 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 	}
 }
 
+const Font::LayoutCacheEntry &Font::getLayout(const std::vector<ColoredString> &text, const Colorf &constantcolor, bool formatted, float wrap, AlignMode align)
+{
+	struct
+	{
+		Colorf constantColor;
+		int32 formatted;
+		float wrap;
+		int32 align;
+	} settings = {constantcolor, formatted ? 1 : 0, formatted ? wrap : 0.0f, formatted ? (int32) align : 0};
+
+	uint64 hash = XXH64(&settings, sizeof(settings), 0);
+
+	for (const ColoredString &cstr : text)
+	{
+		hash = XXH64(cstr.str.data(), cstr.str.size(), hash);
+		hash = XXH64(&cstr.color, sizeof(Colorf), hash);
+	}
+
+	auto it = layoutCacheEntries.find(hash);
+
+	if (it != layoutCacheEntries.end())
+	{
+		const LayoutCacheEntry &entry = *it->second;
+
+		bool matches = entry.textureCacheID == textureCacheID
+			&& entry.formatted == formatted
+			&& entry.constantColor == constantcolor
+			&& (!formatted || (entry.wrap == wrap && entry.align == align))
+			&& entry.text.size() == text.size();
+
+		for (size_t i = 0; matches && i < text.size(); i++)
+			matches = entry.text[i].color == text[i].color && entry.text[i].str == text[i].str;
+
+		if (matches)
+		{
+			layoutCacheHits++;
+			layoutCache.splice(layoutCache.begin(), layoutCache, it->second);
+			return layoutCache.front();
+		}
+
+		// Stale, or a different layout with the same hash.
+		layoutCache.erase(it->second);
+		layoutCacheEntries.erase(it);
+	}
+
+	layoutCacheMisses++;
+
+	while (!layoutCache.empty() && layoutCache.size() >= layoutCacheSize)
+	{
+		layoutCacheEntries.erase(layoutCache.back().hash);
+		layoutCache.pop_back();
+	}
+
+	LayoutCacheEntry entry;
+	entry.hash = hash;
+	entry.text = text;
+	entry.constantColor = constantcolor;
+	entry.formatted = formatted;
+	entry.wrap = wrap;
+	entry.align = align;
+
+	ColoredCodepoints codepoints;
+	getCodepointsFromString(text, codepoints);
+
+	if (formatted)
+		entry.drawCommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, entry.vertices);
+	else
+		entry.drawCommands = generateVertices(codepoints, constantcolor, entry.vertices);
+
+	// Generating the vertices may have added glyphs and changed the ID.
+	entry.textureCacheID = textureCacheID;
+
+	layoutCache.push_front(std::move(entry));
+	layoutCacheEntries[hash] = layoutCache.begin();
+
+	return layoutCache.front();
+}
+
+void Font::clearLayoutCache()
+{
+	layoutCache.clear();
+	layoutCacheEntries.clear();
+}
+
+void Font::setLayoutCacheSize(size_t size)
+{
+	layoutCacheSize = size;
+
+	while (layoutCache.size() > layoutCacheSize)
+	{
+		layoutCacheEntries.erase(layoutCache.back().hash);
+		layoutCache.pop_back();
+	}
+}
+
+size_t Font::getLayoutCacheSize() const
+{
+	return layoutCacheSize;
+}
+
+Font::LayoutCacheStats Font::getLayoutCacheStats() const
+{
+	LayoutCacheStats stats;
+	stats.hits = layoutCacheHits;
+	stats.misses = layoutCacheMisses;
+	stats.count = layoutCache.size();
+	return stats;
+}
+
 void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
 {
+	if (layoutCacheSize > 0)
+	{
+		const LayoutCacheEntry &layout = getLayout(text, constantcolor, false, 0.0f, ALIGN_LEFT);
+		printv(gfx, m, layout.drawCommands, layout.vertices);
+		return;
+	}
+
 	ColoredCodepoints codepoints;
 	getCodepointsFromString(text, codepoints);
 
@@ -667,6 +1304,13 @@ void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text
 
 void Font::printf(graphics::Graphics *gfx, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
 {
+	if (layoutCacheSize > 0)
+	{
+		const LayoutCacheEntry &layout = getLayout(text, constantcolor, true, wrap, align);
+		printv(gfx, m, layout.drawCommands, layout.vertices);
+		return;
+	}
+
 	ColoredCodepoints codepoints;
 	getCodepointsFromString(text, codepoints);
 
@@ -911,6 +1555,7 @@ void Font::getWrap(const std::vector<ColoredString> &text, float wraplimit, std:
 void Font::setLineHeight(float height)
 {
 	lineHeight = height;
+	clearLayoutCache();
 }
 
 float Font::getLineHeight() const
@@ -1002,6 +1647,13 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 	// NOTE: this won't invalidate already-rasterized glyphs.
 	for (const Font *f : fallbacks)
 		rasterizers.push_back(f->rasterizers[0]);
+
+	// A cached texture for this combination of fonts can be used if nothing
+	// has been rasterized yet.
+	if (glyphs.empty())
+		loadGlyphCache();
+
+	clearLayoutCache();
 }
 
 float Font::getDPIScale() const
@@ -22,6 +22,7 @@
 
 // STD
 #include <unordered_map>
+#include <list>
 #include <string>
 #include <vector>
 #include <stddef.h>
@@ -33,7 +34,9 @@
 #include "common/Vector.h"
 
 #include "font/Rasterizer.h"
+#include "GlyphPreloadTask.h"
 #include "Image.h"
+#include "SkylinePacker.h"
 #include "vertex.h"
 #include "Volatile.h"
 
@@ -96,6 +99,13 @@ class Font : public Object, public Volatile
 		int vertexcount;
 	};
 
+	struct LayoutCacheStats
+	{
+		uint64 hits;
+		uint64 misses;
+		size_t count;
+	};
+
 	Font(love::font::Rasterizer *r, const Texture::Filter &filter);
 
 	virtual ~Font();
@@ -171,6 +181,38 @@ class Font : public Object, public Volatile
 
 	void setFallbacks(const std::vector<Font *> &fallbacks);
 
+	/**
+	 * Adds glyphs to the font's texture ahead of time, so they don't need to
+	 * be rasterized when text using them is first drawn. If async is true and
+	 * the font is a TrueType font, the glyphs are rasterized on background
+	 * threads instead, and added to the texture the next time the font needs
+	 * a glyph it doesn't have yet.
+	 **/
+	void preload(const Codepoints &codepoints, bool async);
+
+	/**
+	 * Whether glyphs from asynchronous preloads are still being rasterized.
+	 **/
+	bool isPreloading() const;
+
+	/**
+	 * Writes the font's glyph texture and glyph metrics to the save directory.
+	 * While the glyph cache is enabled, TrueType fonts created later with the
+	 * same font data, size and settings start with this texture instead of
+	 * rasterizing their glyphs again.
+	 **/
+	void saveGlyphCache();
+
+	/**
+	 * Sets the maximum number of layouts remembered by print and printf. Text
+	 * which is drawn again with the same wrap limit, alignment and colors
+	 * reuses the vertices generated the first time. 0 disables the cache.
+	 **/
+	void setLayoutCacheSize(size_t size);
+	size_t getLayoutCacheSize() const;
+
+	LayoutCacheStats getLayoutCacheStats() const;
+
 	float getDPIScale() const;
 
 	uint32 getTextureCacheID() const;
@@ -183,6 +225,9 @@ class Font : public Object, public Volatile
 	static bool getConstant(AlignMode in, const char *&out);
 	static std::vector<std::string> getConstants(AlignMode);
 
+	static void setGlyphCacheEnabled(bool enable);
+	static bool isGlyphCacheEnabled();
+
 	static int fontCount;
 
 private:
@@ -192,6 +237,12 @@ class Font : public Object, public Volatile
 		Texture *texture;
 		int spacing;
 		GlyphVertex vertices[4];
+
+		// Location of the glyph's pixels in its texture.
+		int textureX;
+		int textureY;
+		int width;
+		int height;
 	};
 
 	struct TextureSize
@@ -200,13 +251,40 @@ class Font : public Object, public Volatile
 		int height;
 	};
 
+	struct LayoutCacheEntry
+	{
+		uint64 hash;
+
+		std::vector<ColoredString> text;
+		Colorf constantColor;
+		bool formatted;
+		float wrap;
+		AlignMode align;
+
+		// Layouts refer to the font's textures, so they're only valid while
+		// the texture cache ID they were generated with is current.
+		uint32 textureCacheID;
+
+		std::vector<GlyphVertex> vertices;
+		std::vector<DrawCommand> drawCommands;
+	};
+
 	void createTexture();
+	Image *newTexture(int width, int height, const std::vector<uint8> &pixels);
+	void uploadGlyphs();
+	void setGlyphTexCoords(Glyph &g) const;
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(uint32 glyph);
 	const Glyph &addGlyph(uint32 glyph);
+	const Glyph &addGlyph(uint32 glyph, love::font::GlyphData *gd);
+	void addPreloadedGlyphs();
 	const Glyph &findGlyph(uint32 glyph);
 	float getKerning(uint32 leftglyph, uint32 rightglyph);
+	const LayoutCacheEntry &getLayout(const std::vector<ColoredString> &text, const Colorf &constantColor, bool formatted, float wrap, AlignMode align);
+	void clearLayoutCache();
+	uint64 getGlyphCacheKey() const;
+	bool loadGlyphCache();
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
 
 	std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
@@ -231,14 +309,33 @@ class Font : public Object, public Volatile
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
+	// Finds space for new glyphs in the most recent texture.
+	SkylinePacker packer;
+
+	// A copy of the most recent texture's pixels. New glyphs are written here
+	// and uploaded in batches by uploadGlyphs, and the contents are carried
+	// over when the texture grows.
+	std::vector<uint8> texturePixels;
+
+	// The rows of texturePixels which haven't been uploaded yet.
+	int dirtyRowStart;
+	int dirtyRowEnd;
 
 	bool useSpacesAsTab;
 
+	// Asynchronous preloads whose glyphs haven't all been added yet.
+	std::vector<StrongRef<GlyphPreloadTask>> preloadTasks;
+
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	// Layouts generated by print and printf, most recently used first.
+	std::list<LayoutCacheEntry> layoutCache;
+	std::unordered_map<uint64, std::list<LayoutCacheEntry>::iterator> layoutCacheEntries;
+	size_t layoutCacheSize;
+	uint64 layoutCacheHits;
+	uint64 layoutCacheMisses;
+
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
 	// other glyphs), plus one pixel of transparent padding that the quads will
 	// use, for edge antialiasing.
@@ -247,6 +344,13 @@ class Font : public Object, public Volatile
 	// This will be used if the Rasterizer doesn't have a tab character itself.
 	static const int SPACES_PER_TAB = 4;
 
+	static const size_t DEFAULT_LAYOUT_CACHE_SIZE = 256;
+
+	// Incremented when the layout of glyph cache files changes.
+	static const uint32 GLYPH_CACHE_VERSION = 1;
+
+	static bool glyphCacheEnabled;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
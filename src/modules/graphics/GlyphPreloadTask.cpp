@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "GlyphPreloadTask.h"
+#include "thread/parallel.h"
+
+namespace love
+{
+namespace graphics
+{
+
+GlyphPreloadTask::GlyphPreloadTask(const std::vector<StrongRef<love::font::Rasterizer>> &rasterizers, const std::vector<uint32> &glyphs)
+	: glyphs(glyphs)
+	, complete(false)
+	, cancelled(false)
+{
+	threadName = "GlyphPreloadTask";
+
+	for (const auto &r : rasterizers)
+	{
+		if (r->getDataType() != love::font::Rasterizer::DATA_TRUETYPE)
+			throw love::Exception("Only TrueType fonts can preload glyphs asynchronously.");
+
+		this->rasterizers.emplace_back((love::font::TrueTypeRasterizer *) r.get());
+	}
+}
+
+GlyphPreloadTask::~GlyphPreloadTask()
+{
+	// No wait() here: the thread keeps a reference to us until it's done, so
+	// the last release can happen on the thread itself. The task holds its
+	// own references to the Rasterizers, so the Font doesn't have to wait
+	// for it either.
+}
+
+void GlyphPreloadTask::threadFunction()
+{
+	// Each range makes its own copies of the Rasterizers, which is cheap
+	// compared to rasterizing the glyphs in it.
+	const int minglyphsperrange = 32;
+
+	try
+	{
+		love::thread::parallelFor((int) glyphs.size(), minglyphsperrange, [&](int begin, int end)
+		{
+			std::vector<StrongRef<love::font::TrueTypeRasterizer>> copies;
+			for (const auto &r : rasterizers)
+				copies.emplace_back(r->newThreadCopy(), Acquire::NORETAIN);
+
+			std::vector<StrongRef<love::font::GlyphData>> rasterized;
+
+			for (int i = begin; i < end; i++)
+			{
+				if ((i - begin) % minglyphsperrange == 0)
+				{
+					love::thread::Lock lock(mutex);
+					if (cancelled)
+						break;
+
+					results.insert(results.end(), rasterized.begin(), rasterized.end());
+					rasterized.clear();
+				}
+
+				// Same choice of Rasterizer as Font makes for its fallbacks.
+				love::font::TrueTypeRasterizer *r = copies[0];
+				for (const auto &copy : copies)
+				{
+					if (copy->hasGlyph(glyphs[i]))
+					{
+						r = copy;
+						break;
+					}
+				}
+
+				rasterized.emplace_back(r->getGlyphData(glyphs[i]), Acquire::NORETAIN);
+			}
+
+			love::thread::Lock lock(mutex);
+			results.insert(results.end(), rasterized.begin(), rasterized.end());
+		});
+	}
+	catch (love::Exception &)
+	{
+		// Glyphs which failed to rasterize here will be rasterized (and report
+		// their error) when the Font needs them.
+	}
+
+	love::thread::Lock lock(mutex);
+	complete = true;
+}
+
+void GlyphPreloadTask::takeGlyphs(std::vector<StrongRef<love::font::GlyphData>> &glyphdata)
+{
+	love::thread::Lock lock(mutex);
+	glyphdata.insert(glyphdata.end(), results.begin(), results.end());
+	results.clear();
+}
+
+bool GlyphPreloadTask::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void GlyphPreloadTask::cancel()
+{
+	love::thread::Lock lock(mutex);
+	cancelled = true;
+}
+
+} // graphics
+} // love
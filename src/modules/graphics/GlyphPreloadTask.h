@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "font/TrueTypeRasterizer.h"
+#include "font/GlyphData.h"
+#include "thread/threads.h"
+
+// STL
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Rasterizes a list of glyphs from TrueType Rasterizers on background
+ * threads. Every thread uses its own copies of the Rasterizers, so the
+ * originals can keep being used on the main thread. The resulting GlyphData
+ * can be collected (on any thread) while the task is still running.
+ **/
+class GlyphPreloadTask : public love::thread::Threadable
+{
+public:
+
+	GlyphPreloadTask(const std::vector<StrongRef<love::font::Rasterizer>> &rasterizers, const std::vector<uint32> &glyphs);
+	virtual ~GlyphPreloadTask();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+	/**
+	 * Moves the glyphs which have been rasterized so far to the end of the
+	 * given list.
+	 **/
+	void takeGlyphs(std::vector<StrongRef<love::font::GlyphData>> &glyphdata);
+
+	/**
+	 * Whether all glyphs have been rasterized (or the task was cancelled).
+	 * Glyphs may still need to be collected with takeGlyphs.
+	 **/
+	bool isComplete() const;
+
+	/**
+	 * Stops rasterizing glyphs as soon as possible.
+	 **/
+	void cancel();
+
+private:
+
+	std::vector<StrongRef<love::font::TrueTypeRasterizer>> rasterizers;
+	std::vector<uint32> glyphs;
+
+	std::vector<StrongRef<love::font::GlyphData>> results;
+	bool complete;
+	bool cancelled;
+
+	love::thread::MutexRef mutex;
+
+}; // GlyphPreloadTask
+
+} // graphics
+} // love
@@ -352,6 +352,10 @@ class Graphics : public Module
 	{
 		ScreenshotCallback callback = nullptr;
 		void *data = nullptr;
+
+		// Read the pixels into a staging buffer and call back a few frames
+		// later, instead of stalling until the GPU has finished drawing.
+		bool async = false;
 	};
 
 	struct RenderTargetStrongRef;
@@ -720,6 +724,13 @@ class Graphics : public Module
 
 	void captureScreenshot(const ScreenshotInfo &info);
 
+	/**
+	 * Reads back a region of a Canvas without waiting for the GPU. The callback
+	 * in info receives the ImageData from present(), one to three frames
+	 * later.
+	 **/
+	virtual void readCanvasAsync(Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info) = 0;
+
 	void draw(Drawable *drawable, const Matrix4 &m);
 	void draw(Texture *texture, Quad *quad, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
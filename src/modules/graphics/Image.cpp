@@ -40,6 +40,7 @@ Image::Image(const Slices &data, const Settings &settings, bool validatedata)
 	, mipmapsType(settings.mipmaps ? MIPMAPS_GENERATED : MIPMAPS_NONE)
 	, sRGB(isGammaCorrect() && !settings.linear)
 	, usingDefaultTexture(false)
+	, pendingUploads(0)
 {
 	if (validatedata && data.validate() == MIPMAPS_DATA)
 		mipmapsType = MIPMAPS_DATA;
@@ -124,11 +125,11 @@ void Image::uploadImageData(love::image::ImageDataBase *d, int level, int slice,
 	uploadByteData(d->getFormat(), d->getData(), d->getSize(), level, slice, rect);
 }
 
-void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+bool Image::prepareReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y)
 {
 	// No effect if the texture hasn't been created yet.
 	if (getHandle() == 0 || usingDefaultTexture)
-		return;
+		return false;
 
 	if (d->getFormat() != getPixelFormat())
 		throw love::Exception("Pixel formats must match.");
@@ -169,6 +170,14 @@ void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap,
 	else if (isPixelFormatCompressed(d->getFormat()))
 		throw love::Exception("Compressed textures only support replacing the entire Image.");
 
+	return true;
+}
+
+void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	if (!prepareReplacePixels(d, slice, mipmap, x, y))
+		return;
+
 	Graphics::flushStreamDrawsGlobal();
 
 	uploadImageData(d, mipmap, slice, x, y);
@@ -177,6 +186,11 @@ void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap,
 		generateMipmaps();
 }
 
+void Image::replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	replacePixels(d, slice, mipmap, x, y, reloadmipmaps);
+}
+
 void Image::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
 {
 	Graphics::flushStreamDrawsGlobal();
@@ -187,6 +201,11 @@ void Image::replacePixels(const void *data, size_t size, int slice, int mipmap,
 		generateMipmaps();
 }
 
+bool Image::isReady() const
+{
+	return pendingUploads == 0;
+}
+
 bool Image::isCompressed() const
 {
 	return isPixelFormatCompressed(format);
@@ -59,6 +59,9 @@ class Image : public Texture
 		bool mipmaps = false;
 		bool linear = false;
 		float dpiScale = 1.0f;
+
+		// Upload the initial pixel data in the background (newImageAsync).
+		bool asyncUpload = false;
 	};
 
 	struct Slices
@@ -96,6 +99,18 @@ class Image : public Texture
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
+	/**
+	 * Like replacePixels, but the pixels are copied to GPU-visible staging
+	 * memory on a background thread and the texture is updated in a later
+	 * frame. Backends without support for this upload immediately.
+	 **/
+	virtual void replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Whether all asynchronous uploads to this Image have been applied.
+	 **/
+	bool isReady() const;
+
 	bool isFormatLinear() const;
 	bool isCompressed() const;
 	MipmapsType getMipmapsType() const;
@@ -112,6 +127,10 @@ class Image : public Texture
 	Image(const Slices &data, const Settings &settings);
 	Image(TextureType textype, PixelFormat format, int width, int height, int slices, const Settings &settings);
 
+	// Validates the arguments to replacePixels and stores d if it replaces a
+	// whole slice. Returns false if the texture can't be updated right now.
+	bool prepareReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y);
+
 	void uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y);
 	virtual void uploadByteData(PixelFormat pixelformat, const void *data, size_t size, int level, int slice, const Rect &r) = 0;
 
@@ -129,6 +148,9 @@ class Image : public Texture
 	// back to a default texture.
 	bool usingDefaultTexture;
 
+	// Number of asynchronous uploads which haven't been applied yet.
+	int pendingUploads;
+
 private:
 
 	Image(const Slices &data, const Settings &settings, bool validatedata);
@@ -24,13 +24,26 @@
 #include "Graphics.h"
 
 #include "common/math.h"
-#include "modules/math/RandomGenerator.h"
+#include "thread/parallel.h"
 
 // STD
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+
+// Vector square roots and divisions are only available on 64-bit ARM.
+#if defined(__aarch64__)
+#define LOVE_PARTICLE_SIMD_NEON
+#endif
+#endif
+
 namespace love
 {
 namespace graphics
@@ -39,9 +52,11 @@ namespace graphics
 namespace
 {
 
-love::math::RandomGenerator rng;
+// Seeds the random generator of each new ParticleSystem, so systems get
+// different (but reproducible) sequences.
+love::math::RandomGenerator seedGenerator;
 
-float calculate_variation(float inner, float outer, float var)
+float calculate_variation(love::math::RandomGenerator &rng, float inner, float outer, float var)
 {
 	float low = inner - (outer/2.0f)*var;
 	float high = inner + (outer/2.0f)*var;
@@ -49,15 +64,66 @@ float calculate_variation(float inner, float outer, float var)
 	return low*(1-r)+high*r;
 }
 
+// Computes the same transformation as Matrix3::setTransformation and
+// Matrix3::transformXY for a particle's four vertices.
+void transformParticleVertices(Vertex *verts, const float cornersX[4], const float cornersY[4], float x, float y, float angle, float size, const love::Vector2 &offset)
+{
+	float c = cosf(angle), s = sinf(angle);
+
+	float a = c * size;
+	float b = s * size;
+	float cc = -(s * size);
+	float d = c * size;
+	float tx = x - offset.x * a - offset.y * cc;
+	float ty = y - offset.x * b - offset.y * d;
+
+#if defined(LOVE_SIMD_SSE)
+	__m128 cx = _mm_loadu_ps(cornersX);
+	__m128 cy = _mm_loadu_ps(cornersY);
+
+	__m128 vx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), cx), _mm_mul_ps(_mm_set1_ps(cc), cy)), _mm_set1_ps(tx));
+	__m128 vy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(b), cx), _mm_mul_ps(_mm_set1_ps(d), cy)), _mm_set1_ps(ty));
+
+	// (x0, y0, x1, y1) and (x2, y2, x3, y3).
+	__m128 xy01 = _mm_unpacklo_ps(vx, vy);
+	__m128 xy23 = _mm_unpackhi_ps(vx, vy);
+
+	_mm_storel_pi((__m64 *) &verts[0].x, xy01);
+	_mm_storeh_pi((__m64 *) &verts[1].x, xy01);
+	_mm_storel_pi((__m64 *) &verts[2].x, xy23);
+	_mm_storeh_pi((__m64 *) &verts[3].x, xy23);
+#elif defined(LOVE_SIMD_NEON)
+	float32x4_t cx = vld1q_f32(cornersX);
+	float32x4_t cy = vld1q_f32(cornersY);
+
+	float32x4_t vx = vaddq_f32(vaddq_f32(vmulq_n_f32(cx, a), vmulq_n_f32(cy, cc)), vdupq_n_f32(tx));
+	float32x4_t vy = vaddq_f32(vaddq_f32(vmulq_n_f32(cx, b), vmulq_n_f32(cy, d)), vdupq_n_f32(ty));
+
+	// (x0, y0, x1, y1) and (x2, y2, x3, y3).
+	float32x4x2_t xy = vzipq_f32(vx, vy);
+
+	vst1_f32(&verts[0].x, vget_low_f32(xy.val[0]));
+	vst1_f32(&verts[1].x, vget_high_f32(xy.val[0]));
+	vst1_f32(&verts[2].x, vget_low_f32(xy.val[1]));
+	vst1_f32(&verts[3].x, vget_high_f32(xy.val[1]));
+#else
+	for (int v = 0; v < 4; v++)
+	{
+		verts[v].x = (a * cornersX[v]) + (cc * cornersY[v]) + tx;
+		verts[v].y = (b * cornersX[v]) + (d * cornersY[v]) + ty;
+	}
+#endif
+}
+
 } // anonymous namespace
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
 ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, particles()
+	, pHead(-1)
+	, pTail(-1)
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -105,14 +171,15 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
+	initRandomSeed();
 	setBufferSize(size);
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, particles()
+	, pHead(-1)
+	, pTail(-1)
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -157,6 +224,7 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, vertexAttributes(p.vertexAttributes)
 	, buffer(nullptr)
 {
+	initRandomSeed();
 	setBufferSize(maxParticles);
 }
 
@@ -170,6 +238,13 @@ ParticleSystem *ParticleSystem::clone()
 	return new ParticleSystem(*this);
 }
 
+void ParticleSystem::initRandomSeed()
+{
+	love::math::RandomGenerator::Seed seed;
+	seed.b64 = seedGenerator.rand();
+	rng.setSeed(seed);
+}
+
 void ParticleSystem::resetOffset()
 {
 	if (quads.empty())
@@ -185,7 +260,42 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
+		// Round the array lengths up so every array stays 16-byte aligned.
+		size_t stride = (size + 3) & ~((size_t) 3);
+
+		size_t floatbytes = sizeof(float) * stride;
+		size_t intbytes = sizeof(int) * stride;
+
+		pMem = new char[floatbytes * 20 + sizeof(Colorf) * stride + intbytes * 3];
+		char *mem = pMem;
+
+		float **floatarrays[] =
+		{
+			&particles.lifetime, &particles.life,
+			&particles.positionX, &particles.positionY,
+			&particles.originX, &particles.originY,
+			&particles.velocityX, &particles.velocityY,
+			&particles.linearAccelerationX, &particles.linearAccelerationY,
+			&particles.radialAcceleration, &particles.tangentialAcceleration,
+			&particles.linearDamping,
+			&particles.size, &particles.sizeOffset, &particles.sizeIntervalSize,
+			&particles.rotation, &particles.angle,
+			&particles.spinStart, &particles.spinEnd,
+		};
+
+		for (float **arr : floatarrays)
+		{
+			*arr = (float *) mem;
+			mem += floatbytes;
+		}
+
+		particles.color = (Colorf *) mem;
+		mem += sizeof(Colorf) * stride;
+
+		particles.quadIndex = (int *) mem;
+		particles.prev = (int *) (mem + intbytes);
+		particles.next = (int *) (mem + intbytes * 2);
+
 		maxParticles = (uint32) size;
 
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
@@ -206,6 +316,7 @@ void ParticleSystem::deleteBuffers()
 	delete buffer;
 
 	pMem = nullptr;
+	particles = ParticleData();
 	buffer = nullptr;
 	maxParticles = 0;
 	activeParticles = 0;
@@ -230,28 +341,28 @@ void ParticleSystem::addParticle(float t)
 	if (isFull())
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
+	// The first free particle is the one right after the active particles.
+	int index = (int) activeParticles;
+	initParticle(index, t);
 
 	switch (insertMode)
 	{
 	default:
 	case INSERT_MODE_TOP:
-		insertTop(p);
+		insertTop(index);
 		break;
 	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
+		insertBottom(index);
 		break;
 	case INSERT_MODE_RANDOM:
-		insertRandom(p);
+		insertRandom(index);
 		break;
 	}
 
 	activeParticles++;
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(int index, float t)
 {
 	float min,max;
 
@@ -260,13 +371,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	min = particleLifeMin;
 	max = particleLifeMax;
+	float plife;
 	if (min == max)
-		p->life = min;
+		plife = min;
 	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+		plife = (float) rng.random(min, max);
 
-	p->position = pos;
+	particles.life[index] = plife;
+	particles.lifetime[index] = plife;
+
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -282,15 +396,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -298,16 +412,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -316,26 +430,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -345,83 +459,92 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
+
+	particles.positionX[index] = ppos.x;
+	particles.positionY[index] = ppos.y;
 
-	p->origin = pos;
+	particles.originX[index] = pos.x;
+	particles.originY[index] = pos.y;
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	particles.velocityX[index] = velocity.x;
+	particles.velocityY[index] = velocity.y;
+
+	particles.linearAccelerationX[index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	particles.linearAccelerationY[index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	particles.radialAcceleration[index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	particles.tangentialAcceleration[index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	particles.linearDamping[index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeOffset = (float) rng.random(sizeVariation); // time offset for size change
+	particles.sizeOffset[index]       = sizeOffset;
+	particles.sizeIntervalSize[index] = (1.0f - (float) rng.random(sizeVariation)) - sizeOffset;
+	particles.size[index] = sizes[(size_t)(sizeOffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	particles.spinStart[index] = calculate_variation(rng, spinStart, spinEnd, spinVariation);
+	particles.spinEnd[index] = calculate_variation(rng, spinEnd, spinStart, spinVariation);
+	float rotation = (float) rng.random(min, max);
+	particles.rotation[index] = rotation;
 
-	p->angle = p->rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
+		rotation += atan2f(velocity.y, velocity.x);
+	particles.angle[index] = rotation;
 
-	p->color = colors[0];
+	particles.color[index] = colors[0];
 
-	p->quadIndex = 0;
+	particles.quadIndex[index] = 0;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+void ParticleSystem::insertTop(int index)
 {
-	if (pHead == nullptr)
+	if (pHead == -1)
 	{
-		pHead = p;
-		p->prev = nullptr;
+		pHead = index;
+		particles.prev[index] = -1;
 	}
 	else
 	{
-		pTail->next = p;
-		p->prev = pTail;
+		particles.next[pTail] = index;
+		particles.prev[index] = pTail;
 	}
-	p->next = nullptr;
-	pTail = p;
+	particles.next[index] = -1;
+	pTail = index;
 }
 
-void ParticleSystem::insertBottom(Particle *p)
+void ParticleSystem::insertBottom(int index)
 {
-	if (pTail == nullptr)
+	if (pTail == -1)
 	{
-		pTail = p;
-		p->next = nullptr;
+		pTail = index;
+		particles.next[index] = -1;
 	}
 	else
 	{
-		pHead->prev = p;
-		p->next = pHead;
+		particles.prev[pHead] = index;
+		particles.next[index] = pHead;
 	}
-	p->prev = nullptr;
-	pHead = p;
+	particles.prev[index] = -1;
+	pHead = index;
 }
 
-void ParticleSystem::insertRandom(Particle *p)
+void ParticleSystem::insertRandom(int index)
 {
 	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
 	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
@@ -429,72 +552,104 @@ void ParticleSystem::insertRandom(Particle *p)
 	// Special case where the particle gets inserted before the head.
 	if (pos == activeParticles)
 	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
+		int a = pHead;
+		if (a != -1)
+			particles.prev[a] = index;
+		else
+			pTail = index;
+		particles.prev[index] = -1;
+		particles.next[index] = a;
+		pHead = index;
 		return;
 	}
 
 	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
+	int a = (int) pos;
+	int b = particles.next[a];
+	particles.next[a] = index;
+	if (b != -1)
+		particles.prev[b] = index;
 	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+		pTail = index;
+	particles.prev[index] = a;
+	particles.next[index] = b;
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
+int ParticleSystem::removeParticle(int index)
 {
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
+	// The linked list is updated in this function and old indices may be
+	// invalidated. The returned index will inform the caller of the new
+	// index of the next particle.
+	int *prev = particles.prev;
+	int *next = particles.next;
+
+	int pNext = next[index];
 
 	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
+	if (prev[index] != -1)
+		next[prev[index]] = next[index];
 	else
-		pHead = p->next;
+		pHead = next[index];
 
-	if (p->next)
-	{
-		p->next->prev = p->prev;
-		pNext = p->next;
-	}
+	if (next[index] != -1)
+		prev[next[index]] = prev[index];
 	else
-		pTail = p->prev;
+		pTail = prev[index];
 
 	// The (in memory) last particle can now be moved into the free slot.
 	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
+	int last = (int) activeParticles - 1;
+	if (index != last)
 	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
+		copyParticle(index, last);
+		if (pNext == last)
+			pNext = index;
 
-		if (p->prev)
-			p->prev->next = p;
+		if (prev[index] != -1)
+			next[prev[index]] = index;
 		else
-			pHead = p;
+			pHead = index;
 
-		if (p->next)
-			p->next->prev = p;
+		if (next[index] != -1)
+			prev[next[index]] = index;
 		else
-			pTail = p;
+			pTail = index;
 	}
 
 	activeParticles--;
 	return pNext;
 }
 
+void ParticleSystem::copyParticle(int dst, int src)
+{
+	ParticleData &p = particles;
+
+	p.lifetime[dst] = p.lifetime[src];
+	p.life[dst] = p.life[src];
+	p.positionX[dst] = p.positionX[src];
+	p.positionY[dst] = p.positionY[src];
+	p.originX[dst] = p.originX[src];
+	p.originY[dst] = p.originY[src];
+	p.velocityX[dst] = p.velocityX[src];
+	p.velocityY[dst] = p.velocityY[src];
+	p.linearAccelerationX[dst] = p.linearAccelerationX[src];
+	p.linearAccelerationY[dst] = p.linearAccelerationY[src];
+	p.radialAcceleration[dst] = p.radialAcceleration[src];
+	p.tangentialAcceleration[dst] = p.tangentialAcceleration[src];
+	p.linearDamping[dst] = p.linearDamping[src];
+	p.size[dst] = p.size[src];
+	p.sizeOffset[dst] = p.sizeOffset[src];
+	p.sizeIntervalSize[dst] = p.sizeIntervalSize[src];
+	p.rotation[dst] = p.rotation[src];
+	p.angle[dst] = p.angle[src];
+	p.spinStart[dst] = p.spinStart[src];
+	p.spinEnd[dst] = p.spinEnd[src];
+	p.color[dst] = p.color[src];
+	p.quadIndex[dst] = p.quadIndex[src];
+	p.prev[dst] = p.prev[src];
+	p.next[dst] = p.next[src];
+}
+
 void ParticleSystem::setTexture(Texture *tex)
 {
 	if (texture->getTextureType() != TEXTURE_2D)
@@ -862,9 +1017,8 @@ void ParticleSystem::reset()
 	if (pMem == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
+	pHead = -1;
+	pTail = -1;
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
@@ -906,99 +1060,251 @@ bool ParticleSystem::isFull() const
 	return activeParticles == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
+void ParticleSystem::updateBatch(const std::vector<ParticleSystem *> &systems, float dt)
 {
-	if (pMem == nullptr || dt == 0.0f)
-		return;
+	// Each system only touches its own particles and random generator, but
+	// the same system in two places would be updated by two threads at once.
+	std::vector<ParticleSystem *> sorted = systems;
+	std::sort(sorted.begin(), sorted.end());
+	if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+		throw love::Exception("A ParticleSystem can only be updated once per batch.");
+
+	love::thread::parallelFor((int) systems.size(), 1, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+			systems[i]->update(dt);
+	});
+}
+
+bool ParticleSystem::integrateParticles(uint32 count, float dt)
+{
+	ParticleData &p = particles;
+	bool died = false;
+	uint32 i = 0;
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
+	// The vectorized paths below perform the same operations in the same
+	// order as the scalar loop, so all paths produce identical results.
+#if defined(LOVE_SIMD_SSE)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 vdt = _mm_set1_ps(dt);
+	__m128 dead = zero;
 
-	while (p)
+	for (; i + 4 <= count; i += 4)
 	{
 		// Decrease lifespan.
-		p->life -= dt;
+		__m128 life = _mm_sub_ps(_mm_loadu_ps(&p.life[i]), vdt);
+		_mm_storeu_ps(&p.life[i], life);
+		dead = _mm_or_ps(dead, _mm_cmple_ps(life, zero));
+
+		__m128 px = _mm_loadu_ps(&p.positionX[i]);
+		__m128 py = _mm_loadu_ps(&p.positionY[i]);
+
+		// Normalized vector from particle center to particle.
+		__m128 rx = _mm_sub_ps(px, _mm_loadu_ps(&p.originX[i]));
+		__m128 ry = _mm_sub_ps(py, _mm_loadu_ps(&p.originY[i]));
+		__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+		__m128 haslen = _mm_cmpgt_ps(len, zero);
+		__m128 m = _mm_div_ps(one, len);
+		rx = _mm_or_ps(_mm_and_ps(haslen, _mm_mul_ps(rx, m)), _mm_andnot_ps(haslen, rx));
+		ry = _mm_or_ps(_mm_and_ps(haslen, _mm_mul_ps(ry, m)), _mm_andnot_ps(haslen, ry));
+
+		// Radial, tangential and linear acceleration.
+		__m128 ra = _mm_loadu_ps(&p.radialAcceleration[i]);
+		__m128 ta = _mm_loadu_ps(&p.tangentialAcceleration[i]);
+		__m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(ry, ta)), _mm_loadu_ps(&p.linearAccelerationX[i]));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), _mm_loadu_ps(&p.linearAccelerationY[i]));
+
+		// Update velocity and apply damping.
+		__m128 damping = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(&p.linearDamping[i]), vdt)));
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(&p.velocityX[i]), _mm_mul_ps(ax, vdt));
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(&p.velocityY[i]), _mm_mul_ps(ay, vdt));
+		vx = _mm_mul_ps(vx, damping);
+		vy = _mm_mul_ps(vy, damping);
+		_mm_storeu_ps(&p.velocityX[i], vx);
+		_mm_storeu_ps(&p.velocityY[i], vy);
+
+		// Modify position.
+		_mm_storeu_ps(&p.positionX[i], _mm_add_ps(px, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(&p.positionY[i], _mm_add_ps(py, _mm_mul_ps(vy, vdt)));
+
+		// Rotate.
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(life, _mm_loadu_ps(&p.lifetime[i])));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&p.spinStart[i]), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(&p.spinEnd[i]), t));
+		__m128 rotation = _mm_add_ps(_mm_loadu_ps(&p.rotation[i]), _mm_mul_ps(spin, vdt));
+		_mm_storeu_ps(&p.rotation[i], rotation);
+		_mm_storeu_ps(&p.angle[i], rotation);
+	}
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
-		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
+	died = _mm_movemask_ps(dead) != 0;
+#elif defined(LOVE_PARTICLE_SIMD_NEON)
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t vdt = vdupq_n_f32(dt);
+	uint32x4_t dead = vdupq_n_u32(0);
 
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
+	// vmlaq_f32 may be fused on some compilers, so multiplies and adds are
+	// kept separate to match the scalar results.
+	for (; i + 4 <= count; i += 4)
+	{
+		// Decrease lifespan.
+		float32x4_t life = vsubq_f32(vld1q_f32(&p.life[i]), vdt);
+		vst1q_f32(&p.life[i], life);
+		dead = vorrq_u32(dead, vcleq_f32(life, zero));
+
+		float32x4_t px = vld1q_f32(&p.positionX[i]);
+		float32x4_t py = vld1q_f32(&p.positionY[i]);
+
+		// Normalized vector from particle center to particle.
+		float32x4_t rx = vsubq_f32(px, vld1q_f32(&p.originX[i]));
+		float32x4_t ry = vsubq_f32(py, vld1q_f32(&p.originY[i]));
+		float32x4_t len = vsqrtq_f32(vaddq_f32(vmulq_f32(rx, rx), vmulq_f32(ry, ry)));
+		uint32x4_t haslen = vcgtq_f32(len, zero);
+		float32x4_t m = vdivq_f32(one, len);
+		rx = vbslq_f32(haslen, vmulq_f32(rx, m), rx);
+		ry = vbslq_f32(haslen, vmulq_f32(ry, m), ry);
+
+		// Radial, tangential and linear acceleration.
+		float32x4_t ra = vld1q_f32(&p.radialAcceleration[i]);
+		float32x4_t ta = vld1q_f32(&p.tangentialAcceleration[i]);
+		float32x4_t ax = vaddq_f32(vsubq_f32(vmulq_f32(rx, ra), vmulq_f32(ry, ta)), vld1q_f32(&p.linearAccelerationX[i]));
+		float32x4_t ay = vaddq_f32(vaddq_f32(vmulq_f32(ry, ra), vmulq_f32(rx, ta)), vld1q_f32(&p.linearAccelerationY[i]));
+
+		// Update velocity and apply damping.
+		float32x4_t damping = vdivq_f32(one, vaddq_f32(one, vmulq_f32(vld1q_f32(&p.linearDamping[i]), vdt)));
+		float32x4_t vx = vaddq_f32(vld1q_f32(&p.velocityX[i]), vmulq_f32(ax, vdt));
+		float32x4_t vy = vaddq_f32(vld1q_f32(&p.velocityY[i]), vmulq_f32(ay, vdt));
+		vx = vmulq_f32(vx, damping);
+		vy = vmulq_f32(vy, damping);
+		vst1q_f32(&p.velocityX[i], vx);
+		vst1q_f32(&p.velocityY[i], vy);
+
+		// Modify position.
+		vst1q_f32(&p.positionX[i], vaddq_f32(px, vmulq_f32(vx, vdt)));
+		vst1q_f32(&p.positionY[i], vaddq_f32(py, vmulq_f32(vy, vdt)));
+
+		// Rotate.
+		float32x4_t t = vsubq_f32(one, vdivq_f32(life, vld1q_f32(&p.lifetime[i])));
+		float32x4_t spin = vaddq_f32(vmulq_f32(vld1q_f32(&p.spinStart[i]), vsubq_f32(one, t)), vmulq_f32(vld1q_f32(&p.spinEnd[i]), t));
+		float32x4_t rotation = vaddq_f32(vld1q_f32(&p.rotation[i]), vmulq_f32(spin, vdt));
+		vst1q_f32(&p.rotation[i], rotation);
+		vst1q_f32(&p.angle[i], rotation);
+	}
 
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
+	died = vmaxvq_u32(dead) != 0;
+#endif
 
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
+	// Remaining particles (or all of them, without SIMD support).
+	for (; i < count; i++)
+	{
+		// Decrease lifespan.
+		float life = p.life[i] - dt;
+		p.life[i] = life;
+		if (life <= 0)
+			died = true;
 
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
+		// Get vector from particle center to particle.
+		love::Vector2 ppos(p.positionX[i], p.positionY[i]);
+		love::Vector2 radial = ppos - love::Vector2(p.originX[i], p.originY[i]);
+		radial.normalize();
 
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+		// Tangential acceleration is perpendicular to the radial one.
+		love::Vector2 tangential(-radial.y, radial.x);
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+		radial *= p.radialAcceleration[i];
+		tangential *= p.tangentialAcceleration[i];
 
-			// Modify position.
-			ppos += p->velocity * dt;
+		// Update velocity.
+		love::Vector2 velocity(p.velocityX[i], p.velocityY[i]);
+		velocity += (radial + tangential + love::Vector2(p.linearAccelerationX[i], p.linearAccelerationY[i])) * dt;
 
-			p->position = ppos;
+		// Apply damping.
+		velocity *= 1.0f / (1.0f + p.linearDamping[i] * dt);
 
-			const float t = 1.0f - p->life / p->lifetime;
+		p.velocityX[i] = velocity.x;
+		p.velocityY[i] = velocity.y;
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+		// Modify position.
+		ppos += velocity * dt;
 
-			p->angle = p->rotation;
+		p.positionX[i] = ppos.x;
+		p.positionY[i] = ppos.y;
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+		const float t = 1.0f - life / p.lifetime[i];
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
+		// Rotate.
+		p.rotation[i] += (p.spinStart[i] * (1.0f - t) + p.spinEnd[i] * t) * dt;
 
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
+		p.angle[i] = p.rotation[i];
+	}
 
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+	// Attributes that are looked up from the size, color and quad lists. Dead
+	// particles are skipped since t can be out of range for them.
+	for (i = 0; i < count; i++)
+	{
+		const float life = p.life[i];
+		if (life <= 0)
+			continue;
+
+		const float t = 1.0f - life / p.lifetime[i];
+
+		if (relativeRotation)
+			p.angle[i] += atan2f(p.velocityY[i], p.velocityX[i]);
+
+		// Change size according to given intervals:
+		// i = 0       1       2      3          n-1
+		//     |-------|-------|------|--- ... ---|
+		// t = 0    1/(n-1)        3/(n-1)        1
+		//
+		// `s' is the interpolation variable scaled to the current
+		// interval width, e.g. if n = 5 and t = 0.3, then the current
+		// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+		float s = p.sizeOffset[i] + t * p.sizeIntervalSize[i]; // size variation
+		s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
+		size_t j = (size_t)s;
+		size_t k = (j == sizes.size() - 1) ? j : j + 1; // boundary check (prevents failing on t = 1.0f)
+		s -= (float)j; // transpose s to be in interval [0:1]: j <= s < j + 1 ~> 0 <= s < 1
+		p.size[i] = sizes[j] * (1.0f - s) + sizes[k] * s;
+
+		// Update color according to given intervals (as above)
+		s = t * (float)(colors.size() - 1);
+		j = (size_t)s;
+		k = (j == colors.size() - 1) ? j : j + 1;
+		s -= (float)j;                            // 0 <= s <= 1
+		p.color[i] = colors[j] * (1.0f - s) + colors[k] * s;
+
+		// Update the quad index.
+		k = quads.size();
+		if (k > 0)
+		{
+			s = t * (float) k; // [0:numquads-1] (clamped below)
+			j = (s > 0.0f) ? (size_t) s : 0;
+			p.quadIndex[i] = (int) ((j < k) ? j : k - 1);
+		}
+	}
+
+	return died;
+}
+
+void ParticleSystem::update(float dt)
+{
+	if (pMem == nullptr || dt == 0.0f)
+		return;
 
-			// Next particle.
-			p = p->next;
+	// Update all particles in memory order, so they can be processed several
+	// at a time.
+	if (integrateParticles(activeParticles, dt))
+	{
+		// Remove dead particles while traversing the list in draw order, so
+		// the memory layout (which insertRandom depends on) stays the same
+		// as if each particle was removed when it was visited.
+		int i = pHead;
+		while (i != -1)
+		{
+			if (particles.life[i] <= 0)
+				i = removeParticle(i);
+			else
+				i = particles.next[i];
 		}
 	}
 
@@ -1040,29 +1346,39 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
+	float cornersX[4], cornersY[4];
+	for (int v = 0; v < 4; v++)
+	{
+		cornersX[v] = positions[v].x;
+		cornersY[v] = positions[v].y;
+	}
+
 	Vertex *pVerts = (Vertex *) buffer->map();
-	Particle *p = pHead;
+	const ParticleData &p = particles;
 
 	bool useQuads = !quads.empty();
 
-	Matrix3 t;
-
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (int i = pHead; i != -1; i = p.next[i])
 	{
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			positions = quads[p.quadIndex[i]]->getVertexPositions();
+			texcoords = quads[p.quadIndex[i]]->getVertexTexCoords();
+
+			for (int v = 0; v < 4; v++)
+			{
+				cornersX[v] = positions[v].x;
+				cornersY[v] = positions[v].y;
+			}
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
-		t.transformXY(pVerts, positions, 4);
+		transformParticleVertices(pVerts, cornersX, cornersY, p.positionX[i], p.positionY[i], p.angle[i], p.size[i], offset);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+		Color32 c = toColor32(p.color[i]);
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
@@ -1073,7 +1389,6 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 		}
 
 		pVerts += 4;
-		p = p->next;
 	}
 
 	buffer->unmap();
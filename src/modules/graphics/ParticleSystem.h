@@ -30,6 +30,7 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "modules/math/RandomGenerator.h"
 
 // STL
 #include <vector>
@@ -510,6 +511,15 @@ class ParticleSystem : public Drawable
 	 **/
 	void update(float dt);
 
+	/**
+	 * Updates several particle systems at once, spread across multiple
+	 * threads. Each system has its own random generator, so the results are
+	 * the same as calling update on each of them in order.
+	 * @param systems The particle systems to update. Each may appear once.
+	 * @param dt Time since last update.
+	 **/
+	static void updateBatch(const std::vector<ParticleSystem *> &systems, float dt);
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -523,66 +533,84 @@ class ParticleSystem : public Drawable
 
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Particle attributes, stored as a structure of arrays so update() can
+	// integrate several particles at once. The active particles occupy
+	// indices [0, activeParticles) of every array.
+	struct ParticleData
 	{
-		Particle *prev;
-		Particle *next;
-
-		float lifetime;
-		float life;
+		float *lifetime;
+		float *life;
 
-		love::Vector2 position;
+		float *positionX;
+		float *positionY;
 
 		// Particles gravitate towards this point.
-		love::Vector2 origin;
+		float *originX;
+		float *originY;
 
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
+		float *velocityX;
+		float *velocityY;
+		float *linearAccelerationX;
+		float *linearAccelerationY;
+		float *radialAcceleration;
+		float *tangentialAcceleration;
 
-		float linearDamping;
+		float *linearDamping;
 
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
+		float *size;
+		float *sizeOffset;
+		float *sizeIntervalSize;
 
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
+		float *rotation; // Amount of rotation applied to the final angle.
+		float *angle;
+		float *spinStart;
+		float *spinEnd;
 
-		Colorf color;
+		Colorf *color;
 
-		int quadIndex;
+		int *quadIndex;
+
+		// The draw order, as a doubly linked list of particle indices. An
+		// index of -1 terminates the list.
+		int *prev;
+		int *next;
 	};
 
+	void initRandomSeed();
 	void resetOffset();
 
 	void createBuffers(size_t size);
 	void deleteBuffers();
 
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
+	int removeParticle(int index);
+
+	// Copies all attributes of a particle, including its list links.
+	void copyParticle(int dst, int src);
 
 	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void initParticle(int index, float t);
+	void insertTop(int index);
+	void insertBottom(int index);
+	void insertRandom(int index);
+
+	// Called by update. Returns whether any particle ran out of life.
+	bool integrateParticles(uint32 count, float dt);
+
+	// The allocated memory backing the particle arrays.
+	char *pMem;
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// The particle attributes.
+	ParticleData particles;
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// Index of the start of the linked list, or -1 if it's empty.
+	int pHead;
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	// Index of the end of the linked list, or -1 if it's empty.
+	int pTail;
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Used for the random attributes of new particles.
+	love::math::RandomGenerator rng;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
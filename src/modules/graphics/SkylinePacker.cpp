@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SkylinePacker.h"
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+	reset(width, height);
+}
+
+void SkylinePacker::reset(int width, int height)
+{
+	this->width = width;
+	this->height = height;
+
+	skyline.clear();
+	skyline.push_back({0, 0, width});
+}
+
+void SkylinePacker::grow(int width, int height)
+{
+	if (width > this->width)
+	{
+		Node &last = skyline.back();
+		if (last.y == 0)
+			last.width += width - this->width;
+		else
+			skyline.push_back({this->width, 0, width - this->width});
+
+		this->width = width;
+	}
+
+	this->height = std::max(height, this->height);
+}
+
+bool SkylinePacker::isEmpty() const
+{
+	return skyline.size() == 1 && skyline[0].y == 0;
+}
+
+const std::vector<SkylinePacker::Node> &SkylinePacker::getSkyline() const
+{
+	return skyline;
+}
+
+bool SkylinePacker::setSkyline(int width, int height, const std::vector<Node> &nodes)
+{
+	// The nodes have to cover the whole width, in order.
+	int x = 0;
+	for (const Node &n : nodes)
+	{
+		if (n.x != x || n.width <= 0 || n.y < 0 || n.y > height)
+			return false;
+		x += n.width;
+	}
+
+	if (x != width)
+		return false;
+
+	this->width = width;
+	this->height = height;
+	skyline = nodes;
+	return true;
+}
+
+int SkylinePacker::fit(size_t node, int width, int height) const
+{
+	int x = skyline[node].x;
+	if (x + width > this->width)
+		return -1;
+
+	// The rectangle rests on the highest node it spans.
+	int y = 0;
+	int remaining = width;
+
+	for (size_t i = node; remaining > 0; i++)
+	{
+		y = std::max(y, skyline[i].y);
+		if (y + height > this->height)
+			return -1;
+
+		remaining -= skyline[i].width;
+	}
+
+	return y;
+}
+
+bool SkylinePacker::pack(int width, int height, int &x, int &y)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	size_t bestnode = 0;
+	int besttop = -1;
+	int bestwidth = 0;
+
+	// Bottom-left: pick the position whose top edge is lowest, preferring
+	// the narrowest node on ties so wide gaps stay available.
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int nodey = fit(i, width, height);
+		if (nodey < 0)
+			continue;
+
+		int top = nodey + height;
+		if (besttop < 0 || top < besttop || (top == besttop && skyline[i].width < bestwidth))
+		{
+			bestnode = i;
+			besttop = top;
+			bestwidth = skyline[i].width;
+		}
+	}
+
+	if (besttop < 0)
+		return false;
+
+	x = skyline[bestnode].x;
+	y = besttop - height;
+
+	// Raise the skyline under the new rectangle, shrinking or removing the
+	// nodes it covers.
+	Node newnode = {x, besttop, width};
+	skyline.insert(skyline.begin() + bestnode, newnode);
+
+	size_t i = bestnode + 1;
+	while (i < skyline.size())
+	{
+		Node &n = skyline[i];
+		int shrink = (newnode.x + newnode.width) - n.x;
+		if (shrink <= 0)
+			break;
+
+		if (shrink < n.width)
+		{
+			n.x += shrink;
+			n.width -= shrink;
+			break;
+		}
+
+		skyline.erase(skyline.begin() + i);
+	}
+
+	// Merge neighbouring nodes at the same height.
+	for (i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+
+	return true;
+}
+
+} // graphics
+} // love
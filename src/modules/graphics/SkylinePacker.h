@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_GRAPHICS_SKYLINE_PACKER_H
+#define LOVE_GRAPHICS_SKYLINE_PACKER_H
+
+// STL
+#include <vector>
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Packs rectangles into a 2D area using the skyline bottom-left heuristic.
+ * The area can grow after rectangles have been packed, without moving them.
+ **/
+class SkylinePacker
+{
+public:
+
+	// A horizontal segment of the skyline. Everything below y is used.
+	struct Node
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	SkylinePacker(int width, int height);
+
+	/**
+	 * Finds a free position for a rectangle of the given size and marks it as
+	 * used. Returns false if it doesn't fit anywhere.
+	 **/
+	bool pack(int width, int height, int &x, int &y);
+
+	/**
+	 * Clears all packed rectangles and sets the size of the area.
+	 **/
+	void reset(int width, int height);
+
+	/**
+	 * Grows the area, keeping all packed rectangles where they are.
+	 **/
+	void grow(int width, int height);
+
+	bool isEmpty() const;
+
+	/**
+	 * Gets or restores the packer's state, e.g. to save it along with the
+	 * packed contents. setSkyline returns false if the nodes aren't valid for
+	 * the given size.
+	 **/
+	const std::vector<Node> &getSkyline() const;
+	bool setSkyline(int width, int height, const std::vector<Node> &nodes);
+
+private:
+
+	// Returns the y coordinate a rectangle placed at the start of the given
+	// node would be at, or -1 if it doesn't fit there.
+	int fit(size_t node, int width, int height) const;
+
+	std::vector<Node> skyline;
+
+	int width;
+	int height;
+
+}; // SkylinePacker
+
+} // graphics
+} // love
+
+#endif // LOVE_GRAPHICS_SKYLINE_PACKER_H
@@ -457,8 +457,15 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 {
 	love::image::ImageData *data = love::graphics::Canvas::newImageData(module, slice, mipmap, r);
 
+	readPixels(slice, mipmap, r, data->getFormat(), data->getData());
+
+	return data;
+}
+
+void Canvas::readPixels(int slice, int mipmap, const Rect &r, PixelFormat dataformat, void *dst)
+{
 	bool isSRGB = false;
-	OpenGL::TextureFormat fmt = gl.convertPixelFormat(data->getFormat(), false, isSRGB);
+	OpenGL::TextureFormat fmt = gl.convertPixelFormat(dataformat, false, isSRGB);
 
 	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getFBO());
@@ -470,14 +477,12 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, mipmap, layer, face);
 	}
 
-	glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, data->getData());
+	glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, dst);
 
 	if (slice > 0 || mipmap > 0)
 		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, 0, 0, 0);
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
-
-	return data;
 }
 
 void Canvas::generateMipmaps()
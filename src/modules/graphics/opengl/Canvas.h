@@ -54,6 +54,10 @@ class Canvas final : public love::graphics::Canvas, public Volatile
 	ptrdiff_t getHandle() const override;
 
 	love::image::ImageData *newImageData(love::image::Image *module, int slice, int mipmap, const Rect &rect) override;
+
+	// Reads a region of the Canvas with glReadPixels. dst is an offset when a
+	// pixel pack buffer is bound.
+	void readPixels(int slice, int mipmap, const Rect &rect, PixelFormat dataformat, void *dst);
 	void generateMipmaps() override;
 
 	int getMSAA() const override
@@ -72,6 +72,20 @@ bool FenceSync::cpuWait()
 	return true;
 }
 
+bool FenceSync::isComplete()
+{
+	if (sync == 0)
+		return true;
+
+	GLenum status = glClientWaitSync(sync, 0, 0);
+
+	if (status == GL_TIMEOUT_EXPIRED)
+		return false;
+
+	cleanup();
+	return true;
+}
+
 void FenceSync::cleanup()
 {
 	if (sync != 0)
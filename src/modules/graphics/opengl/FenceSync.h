@@ -45,6 +45,10 @@ class FenceSync
 	bool cpuWait();
 	void cleanup();
 
+	// Non-blocking check. Returns true (and cleans up) once the fence has
+	// been reached by the GPU, or if there is no active fence.
+	bool isComplete();
+
 private:
 
 	GLsync sync;
@@ -57,6 +57,8 @@ namespace opengl
 Graphics::Graphics()
 	: windowHasStencil(false)
 	, mainVAO(0)
+	, textureUploadQueue(nullptr)
+	, textureReadbackQueue(nullptr)
 {
 	gl = OpenGL();
 	Canvas::resetFormatSupport();
@@ -84,6 +86,8 @@ Graphics::Graphics()
 
 Graphics::~Graphics()
 {
+	delete textureUploadQueue;
+	delete textureReadbackQueue;
 }
 
 const char *Graphics::getName() const
@@ -96,6 +100,48 @@ love::graphics::StreamBuffer *Graphics::newStreamBuffer(BufferType type, size_t
 	return CreateStreamBuffer(type, size);
 }
 
+TextureUploadQueue *Graphics::getTextureUploadQueue()
+{
+	if (textureUploadQueue == nullptr && isCreated() && TextureUploadQueue::isSupported())
+	{
+		try
+		{
+			textureUploadQueue = new TextureUploadQueue();
+		}
+		catch (love::Exception &)
+		{
+			return nullptr;
+		}
+	}
+
+	return textureUploadQueue;
+}
+
+TextureReadbackQueue *Graphics::getTextureReadbackQueue()
+{
+	if (textureReadbackQueue == nullptr && isCreated())
+		textureReadbackQueue = new TextureReadbackQueue();
+
+	return textureReadbackQueue;
+}
+
+void Graphics::readCanvasAsync(love::graphics::Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info)
+{
+	PixelFormat format = canvas->validateReadback(slice, mipmap, rect);
+
+	TextureReadbackQueue *queue = getTextureReadbackQueue();
+	if (queue == nullptr)
+		throw love::Exception("Canvas:newImageDataAsync cannot be called without an active window.");
+
+	flushStreamDraws();
+
+	Canvas *c = (Canvas *) canvas;
+	queue->enqueue(rect, format, false, {info}, [&](void *dst)
+	{
+		c->readPixels(slice, mipmap, rect, format, dst);
+	});
+}
+
 love::graphics::Image *Graphics::newImage(const Image::Slices &data, const Image::Settings &settings)
 {
 	return new Image(data, settings);
@@ -270,6 +316,15 @@ void Graphics::unSetMode()
 
 	flushStreamDraws();
 
+	// Apply any queued texture uploads while their textures still exist.
+	delete textureUploadQueue;
+	textureUploadQueue = nullptr;
+
+	// Pending readbacks are finished now. Function callbacks can't be called
+	// from here, so they're dropped.
+	delete textureReadbackQueue;
+	textureReadbackQueue = nullptr;
+
 	// Unload all volatile objects. These must be reloaded after the display
 	// mode change.
 	Volatile::unloadAll();
@@ -908,6 +963,30 @@ void Graphics::present(void *screenshotCallbackData)
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, gl.getDefaultFBO());
 
+#ifndef LOVE_IOS
+	// Non-blocking screenshots go through the readback queue. iOS needs an
+	// explicit MSAA resolve first, so it always uses the path below.
+	std::vector<ScreenshotInfo> asyncscreenshots;
+	std::vector<ScreenshotInfo> syncscreenshots;
+
+	for (const ScreenshotInfo &info : pendingScreenshotCallbacks)
+		(info.async ? asyncscreenshots : syncscreenshots).push_back(info);
+
+	pendingScreenshotCallbacks = syncscreenshots;
+
+	if (!asyncscreenshots.empty())
+	{
+		int w = getPixelWidth();
+		int h = getPixelHeight();
+		Rect rect = {0, 0, w, h};
+
+		getTextureReadbackQueue()->enqueue(rect, PIXELFORMAT_RGBA8, true, asyncscreenshots, [&](void *dst)
+		{
+			glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, dst);
+		});
+	}
+#endif
+
 	if (!pendingScreenshotCallbacks.empty())
 	{
 		int w = getPixelWidth();
@@ -1010,6 +1089,12 @@ void Graphics::present(void *screenshotCallbackData)
 		buffer->nextFrame();
 	streamBufferState.indexBuffer->nextFrame();
 
+	if (textureUploadQueue != nullptr)
+		textureUploadQueue->update();
+
+	if (textureReadbackQueue != nullptr)
+		textureReadbackQueue->update(screenshotCallbackData);
+
 	auto window = getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
 		window->swapBuffers();
@@ -39,6 +39,8 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "Shader.h"
+#include "TextureUploadQueue.h"
+#include "TextureReadbackQueue.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -71,6 +73,15 @@ class Graphics final : public love::graphics::Graphics
 
 	void setActive(bool active) override;
 
+	// Gets the queue used for background texture uploads, or null if the
+	// context doesn't support it.
+	TextureUploadQueue *getTextureUploadQueue();
+
+	// Gets the queue used for non-blocking pixel readback.
+	TextureReadbackQueue *getTextureReadbackQueue();
+
+	void readCanvasAsync(love::graphics::Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info) override;
+
 	void draw(const DrawCommand &cmd) override;
 	void draw(const DrawIndexedCommand &cmd) override;
 	void drawQuads(int start, int count, const vertex::Attributes &attributes, const vertex::BufferBindings &buffers, Texture *texture) override;
@@ -153,6 +164,9 @@ class Graphics final : public love::graphics::Graphics
 	bool windowHasStencil;
 	GLuint mainVAO;
 
+	TextureUploadQueue *textureUploadQueue;
+	TextureReadbackQueue *textureReadbackQueue;
+
 }; // Graphics
 
 } // opengl
@@ -19,8 +19,9 @@
  **/
 
 #include "Image.h"
+#include "Graphics.h"
+#include "TextureUploadQueue.h"
 
-#include "graphics/Graphics.h"
 #include "common/int.h"
 
 // STD
@@ -36,6 +37,7 @@ namespace opengl
 Image::Image(TextureType textype, PixelFormat format, int width, int height, int slices, const Settings &settings)
 	: love::graphics::Image(textype, format, width, height, slices, settings)
 	, texture(0)
+	, deferInitialUpload(false)
 {
 	loadVolatile();
 }
@@ -43,6 +45,7 @@ Image::Image(TextureType textype, PixelFormat format, int width, int height, int
 Image::Image(const Slices &slices, const Settings &settings)
 	: love::graphics::Image(slices, settings)
 	, texture(0)
+	, deferInitialUpload(settings.asyncUpload)
 {
 	loadVolatile();
 }
@@ -112,6 +115,19 @@ void Image::loadData()
 
 	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format, false, sRGB);
 
+	TextureUploadQueue *queue = nullptr;
+	if (deferInitialUpload)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		queue = gfx != nullptr ? gfx->getTextureUploadQueue() : nullptr;
+		deferInitialUpload = false;
+	}
+
+	// The queue generates mipmaps after the last level is uploaded.
+	int lastslice = slicecount - 1;
+	while (lastslice > 0 && data.get(lastslice, mipcount - 1) == nullptr)
+		lastslice--;
+
 	for (int mip = 0; mip < mipcount; mip++)
 	{
 		if (isCompressed() && (texType == TEXTURE_2D_ARRAY || texType == TEXTURE_VOLUME))
@@ -132,8 +148,27 @@ void Image::loadData()
 		{
 			love::image::ImageDataBase *id = data.get(slice, mip);
 
-			if (id != nullptr)
+			if (id == nullptr)
+				continue;
+
+			Rect rect = {0, 0, id->getWidth(), id->getHeight()};
+			bool last = mip == mipcount - 1 && slice == lastslice;
+			bool genmipmaps = last && mipmapsType == MIPMAPS_GENERATED;
+
+			if (queue != nullptr && queue->enqueue(this, id, mip, slice, rect, genmipmaps))
+				pendingUploads++;
+			else
+			{
+				// Apply anything already queued, so the fallback doesn't
+				// leave mipmap generation to a queued upload.
+				if (queue != nullptr)
+				{
+					queue->flush();
+					queue = nullptr;
+				}
+
 				uploadImageData(id, mip, slice, 0, 0);
+			}
 		}
 
 		w = std::max(w / 2, 1);
@@ -143,7 +178,7 @@ void Image::loadData()
 			d = std::max(d / 2, 1);
 	}
 
-	if (mipmapsType == MIPMAPS_GENERATED)
+	if (mipmapsType == MIPMAPS_GENERATED && pendingUploads == 0)
 		generateMipmaps();
 }
 
@@ -178,6 +213,52 @@ void Image::uploadByteData(PixelFormat pixelformat, const void *data, size_t siz
 	}
 }
 
+void Image::replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	TextureUploadQueue *queue = gfx != nullptr ? gfx->getTextureUploadQueue() : nullptr;
+
+	if (queue == nullptr)
+	{
+		replacePixels(d, slice, mipmap, x, y, reloadmipmaps);
+		return;
+	}
+
+	if (!prepareReplacePixels(d, slice, mipmap, x, y))
+		return;
+
+	Rect rect = {x, y, d->getWidth(), d->getHeight()};
+
+	if (queue->enqueue(this, d, mipmap, slice, rect, reloadmipmaps && mipmap == 0))
+		pendingUploads++;
+	else
+	{
+		Graphics::flushStreamDrawsGlobal();
+		uploadImageData(d, mipmap, slice, x, y);
+
+		if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
+			generateMipmaps();
+	}
+}
+
+void Image::uploadStaged(PixelFormat pixelformat, const void *offset, size_t size, int level, int slice, const Rect &r, bool reloadmipmaps)
+{
+	pendingUploads--;
+
+	// The texture may have been released (e.g. by a mode change) since the
+	// upload was queued. It will be reloaded from its stored data.
+	if (texture == 0 || usingDefaultTexture)
+		return;
+
+	// Draws batched before this point should still see the old contents.
+	Graphics::flushStreamDrawsGlobal();
+
+	uploadByteData(pixelformat, offset, size, level, slice, r);
+
+	if (reloadmipmaps && getMipmapCount() > 1)
+		generateMipmaps();
+}
+
 bool Image::loadVolatile()
 {
 	if (texture != 0)
@@ -54,6 +54,11 @@ class Image final : public love::graphics::Image, public Volatile
 
 	bool setMipmapSharpness(float sharpness) override;
 
+	void replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps) override;
+
+	// Called by TextureUploadQueue with its staging buffer bound.
+	void uploadStaged(PixelFormat pixelformat, const void *offset, size_t size, int level, int slice, const Rect &r, bool reloadmipmaps);
+
 	static bool isFormatSupported(PixelFormat pixelformat, bool sRGB);
 
 private:
@@ -67,6 +72,9 @@ class Image final : public love::graphics::Image, public Volatile
 	// OpenGL texture identifier.
 	GLuint texture;
 
+	// Whether the next loadData should hand the pixels to the upload queue.
+	bool deferInitialUpload;
+
 }; // Image
 
 } // opengl
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TextureReadbackQueue.h"
+#include "common/Exception.h"
+#include "image/Image.h"
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+// OpenGL reads pixels from the lower-left.
+static void flipRows(uint8 *pixels, size_t rowsize, int rows)
+{
+	std::vector<uint8> temp(rowsize);
+
+	for (int y = 0; y < rows / 2; y++)
+	{
+		uint8 *a = pixels + y * rowsize;
+		uint8 *b = pixels + (rows - y - 1) * rowsize;
+
+		memcpy(temp.data(), a, rowsize);
+		memcpy(a, b, rowsize);
+		memcpy(b, temp.data(), rowsize);
+	}
+}
+
+TextureReadbackQueue::TextureReadbackQueue()
+	: supported(isSupported())
+{
+	for (Slot &slot : slots)
+		freeSlots.push_back(&slot);
+}
+
+TextureReadbackQueue::~TextureReadbackQueue()
+{
+	for (Readback *readback : readbacks)
+	{
+		resolve(readback);
+		deliver(readback, nullptr);
+		delete readback;
+	}
+
+	for (Slot &slot : slots)
+	{
+		slot.sync.cleanup();
+		if (slot.buffer != 0)
+			glDeleteBuffers(1, &slot.buffer);
+	}
+}
+
+bool TextureReadbackQueue::isSupported()
+{
+	bool sync = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sync;
+	bool maprange = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0 || GLAD_ARB_map_buffer_range;
+	bool pbo = GLAD_VERSION_2_1 || GLAD_ES_VERSION_3_0 || GLAD_ARB_pixel_buffer_object;
+
+	return sync && maprange && pbo;
+}
+
+void TextureReadbackQueue::enqueue(const Rect &rect, PixelFormat format, bool flip, const std::vector<CallbackInfo> &callbacks, const ReadFunction &read)
+{
+	size_t size = getPixelFormatSize(format) * rect.w * rect.h;
+
+	Readback *readback = new Readback();
+	readback->slot = nullptr;
+	readback->rect = rect;
+	readback->format = format;
+	readback->flip = flip;
+	readback->frames = 0;
+	readback->callbacks = callbacks;
+	readback->failed = false;
+
+	Slot *slot = supported ? acquireSlot(size) : nullptr;
+
+	if (slot != nullptr)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+		read(BUFFER_OFFSET(0));
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		slot->sync.fence();
+		readback->slot = slot;
+	}
+	else
+	{
+		// Read synchronously, but still deliver from update() so callers see
+		// the same behavior either way.
+		try
+		{
+			auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+			if (imagemodule == nullptr)
+				throw love::Exception("love.image must be loaded to read pixels back.");
+
+			readback->result.set(imagemodule->newImageData(rect.w, rect.h, format), Acquire::NORETAIN);
+			read(readback->result->getData());
+
+			if (flip)
+				flipRows((uint8 *) readback->result->getData(), size / rect.h, rect.h);
+		}
+		catch (love::Exception &)
+		{
+			readback->result.set(nullptr);
+			readback->failed = true;
+		}
+	}
+
+	readbacks.push_back(readback);
+}
+
+void TextureReadbackQueue::update(void *callbackdata)
+{
+	for (Readback *readback : readbacks)
+	{
+		if (readback->slot == nullptr)
+			continue;
+
+		readback->frames++;
+
+		if (readback->frames >= MAX_FRAMES_LATENCY || readback->slot->sync.isComplete())
+			resolve(readback);
+	}
+
+	// Deliver in submission order.
+	while (!readbacks.empty() && readbacks.front()->slot == nullptr)
+	{
+		Readback *readback = readbacks.front();
+		readbacks.pop_front();
+
+		deliver(readback, callbackdata);
+		delete readback;
+	}
+}
+
+TextureReadbackQueue::Slot *TextureReadbackQueue::acquireSlot(size_t size)
+{
+	if (freeSlots.empty())
+	{
+		// Every staging buffer is in flight. Finish the oldest readback early;
+		// its result is still delivered in order from update().
+		for (Readback *readback : readbacks)
+		{
+			if (readback->slot != nullptr)
+			{
+				resolve(readback);
+				break;
+			}
+		}
+	}
+
+	if (freeSlots.empty())
+		return nullptr;
+
+	Slot *slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	if (slot->buffer == 0)
+		glGenBuffers(1, &slot->buffer);
+
+	if (slot->size < size)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		slot->size = size;
+	}
+
+	return slot;
+}
+
+void TextureReadbackQueue::resolve(Readback *readback)
+{
+	Slot *slot = readback->slot;
+	if (slot == nullptr)
+		return;
+
+	readback->slot = nullptr;
+
+	slot->sync.cpuWait();
+
+	const Rect &r = readback->rect;
+	size_t rowsize = getPixelFormatSize(readback->format) * r.w;
+	size_t size = rowsize * r.h;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+	const uint8 *src = (const uint8 *) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+
+	try
+	{
+		auto imagemodule = Module::getInstance<love::image::Image>(Module::M_IMAGE);
+
+		if (src == nullptr)
+			throw love::Exception("Could not map the readback buffer.");
+		if (imagemodule == nullptr)
+			throw love::Exception("love.image must be loaded to read pixels back.");
+
+		readback->result.set(imagemodule->newImageData(r.w, r.h, readback->format), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		readback->failed = true;
+	}
+
+	if (!readback->failed)
+	{
+		uint8 *dst = (uint8 *) readback->result->getData();
+
+		if (readback->flip)
+		{
+			for (int y = 0; y < r.h; y++)
+				memcpy(dst + (r.h - y - 1) * rowsize, src + y * rowsize, rowsize);
+		}
+		else
+			memcpy(dst, src, size);
+	}
+
+	if (src != nullptr)
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	freeSlots.push_back(slot);
+}
+
+void TextureReadbackQueue::deliver(Readback *readback, void *callbackdata)
+{
+	love::image::ImageData *img = readback->failed ? nullptr : readback->result.get();
+
+	if (img != nullptr && readback->flip && readback->format == PIXELFORMAT_RGBA8)
+	{
+		// Replace alpha values with full opacity.
+		uint8 *pixels = (uint8 *) img->getData();
+		size_t size = img->getSize();
+
+		for (size_t i = 3; i < size; i += 4)
+			pixels[i] = 255;
+	}
+
+	for (const CallbackInfo &info : readback->callbacks)
+		info.callback(&info, img, callbackdata);
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/math.h"
+#include "common/pixelformat.h"
+#include "graphics/Graphics.h"
+#include "OpenGL.h"
+#include "FenceSync.h"
+
+// C++
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+/**
+ * Reads pixels back from the GPU without stalling. Each readback goes into a
+ * pixel pack buffer followed by a fence, and is copied into an ImageData once
+ * the fence has been reached. Results are delivered through the same
+ * callbacks screenshots use.
+ **/
+class TextureReadbackQueue
+{
+public:
+
+	typedef love::graphics::Graphics::ScreenshotInfo CallbackInfo;
+
+	// Performs the read. dst is an offset into the bound pixel pack buffer,
+	// or client memory when staging buffers aren't supported.
+	typedef std::function<void(void *dst)> ReadFunction;
+
+	TextureReadbackQueue();
+	~TextureReadbackQueue();
+
+	/**
+	 * Starts reading a region with the given format. If flip is true, the rows
+	 * are flipped and alpha is set to full opacity (for screenshots).
+	 **/
+	void enqueue(const Rect &rect, PixelFormat format, bool flip, const std::vector<CallbackInfo> &callbacks, const ReadFunction &read);
+
+	/**
+	 * Copies out finished readbacks and calls their callbacks. Readbacks
+	 * still pending after MAX_FRAMES_LATENCY calls are waited on.
+	 **/
+	void update(void *callbackdata);
+
+	static bool isSupported();
+
+private:
+
+	static const int MAX_FRAMES_LATENCY = 3;
+	static const int MAX_SLOTS = 8;
+
+	struct Slot
+	{
+		GLuint buffer = 0;
+		size_t size = 0;
+		FenceSync sync;
+	};
+
+	struct Readback
+	{
+		Slot *slot;
+		Rect rect;
+		PixelFormat format;
+		bool flip;
+		int frames;
+		std::vector<CallbackInfo> callbacks;
+		StrongRef<love::image::ImageData> result;
+		bool failed;
+	};
+
+	Slot *acquireSlot(size_t size);
+	void resolve(Readback *readback);
+	void deliver(Readback *readback, void *callbackdata);
+
+	bool supported;
+
+	Slot slots[MAX_SLOTS];
+	std::vector<Slot *> freeSlots;
+
+	// Readbacks in submission order.
+	std::deque<Readback *> readbacks;
+
+}; // TextureReadbackQueue
+
+} // opengl
+} // graphics
+} // love
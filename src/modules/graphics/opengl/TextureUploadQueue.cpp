@@ -0,0 +1,315 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TextureUploadQueue.h"
+#include "Image.h"
+#include "common/Exception.h"
+#include "common/memory.h"
+#include "image/ImageData.h"
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+// Staging buffers are allocated in multiples of this, so slightly different
+// upload sizes can reuse the same buffer.
+static const size_t STAGING_ALIGNMENT = 64 * 1024;
+
+TextureUploadQueue::Worker::Worker(TextureUploadQueue *queue)
+	: queue(queue)
+{
+	threadName = "TextureUploadQueue";
+}
+
+void TextureUploadQueue::Worker::threadFunction()
+{
+	love::thread::Lock lock(queue->mutex);
+
+	while (true)
+	{
+		while (queue->copyQueue.empty() && !queue->quit)
+			queue->copyCond->wait(queue->mutex);
+
+		if (queue->copyQueue.empty())
+			break;
+
+		Upload *upload = queue->copyQueue.front();
+		queue->copyQueue.pop_front();
+
+		queue->mutex->unlock();
+
+		love::image::ImageDataBase *source = upload->source.get();
+		auto imagedata = dynamic_cast<love::image::ImageData *>(source);
+
+		if (imagedata != nullptr)
+		{
+			love::thread::Lock datalock(imagedata->getMutex());
+			memcpy(upload->slot->data, source->getData(), source->getSize());
+		}
+		else
+			memcpy(upload->slot->data, source->getData(), source->getSize());
+
+		queue->mutex->lock();
+
+		upload->copied = true;
+		queue->doneCond->broadcast();
+	}
+}
+
+TextureUploadQueue::TextureUploadQueue()
+	: persistent(GLAD_VERSION_4_4 || GLAD_ARB_buffer_storage)
+	, worker(nullptr)
+	, quit(false)
+{
+	worker = new Worker(this);
+
+	if (!worker->start())
+	{
+		worker->release();
+		throw love::Exception("Could not start the texture upload thread.");
+	}
+}
+
+TextureUploadQueue::~TextureUploadQueue()
+{
+	flush();
+
+	{
+		love::thread::Lock lock(mutex);
+		quit = true;
+		copyCond->broadcast();
+	}
+
+	worker->wait();
+	worker->release();
+
+	for (Slot &slot : slots)
+		destroySlot(&slot);
+}
+
+bool TextureUploadQueue::isSupported()
+{
+	bool sync = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0 || GLAD_ARB_sync;
+	bool maprange = GLAD_VERSION_3_0 || GLAD_ES_VERSION_3_0 || GLAD_ARB_map_buffer_range;
+	bool pbo = GLAD_VERSION_2_1 || GLAD_ES_VERSION_3_0 || GLAD_ARB_pixel_buffer_object;
+
+	return sync && maprange && pbo;
+}
+
+bool TextureUploadQueue::enqueue(Image *image, love::image::ImageDataBase *d, int level, int slice, const Rect &rect, bool reloadmipmaps)
+{
+	Slot *slot = acquireSlot(d->getSize());
+	if (slot == nullptr)
+		return false;
+
+	Upload *upload = new Upload();
+	upload->image.set(image);
+	upload->source.set(d);
+	upload->level = level;
+	upload->slice = slice;
+	upload->rect = rect;
+	upload->reloadMipmaps = reloadmipmaps;
+	upload->slot = slot;
+	upload->copied = false;
+
+	uploads.push_back(upload);
+
+	love::thread::Lock lock(mutex);
+	copyQueue.push_back(upload);
+	copyCond->signal();
+
+	return true;
+}
+
+void TextureUploadQueue::update()
+{
+	issueUploads(false);
+}
+
+void TextureUploadQueue::flush()
+{
+	issueUploads(true);
+}
+
+TextureUploadQueue::Slot *TextureUploadQueue::acquireSlot(size_t size)
+{
+	while (true)
+	{
+		Slot *candidate = nullptr;
+
+		for (Slot &slot : slots)
+		{
+			if (slot.busy || !slot.sync.isComplete())
+				continue;
+
+			// Prefer a buffer which is already big enough.
+			if (candidate == nullptr || (slot.buffer != 0 && slot.size >= size))
+				candidate = &slot;
+		}
+
+		if (candidate != nullptr)
+		{
+			if (!mapSlot(candidate, size))
+				return nullptr;
+
+			candidate->busy = true;
+			return candidate;
+		}
+
+		// Every staging buffer is either still being filled or in use by the
+		// GPU. Wait for whichever frees up first.
+		Slot *idle = nullptr;
+		for (Slot &slot : slots)
+		{
+			if (!slot.busy)
+			{
+				idle = &slot;
+				break;
+			}
+		}
+
+		if (idle != nullptr)
+			idle->sync.cpuWait();
+		else
+			issueUploads(true);
+	}
+}
+
+bool TextureUploadQueue::mapSlot(Slot *slot, size_t size)
+{
+	if (slot->buffer != 0 && slot->size < size)
+		destroySlot(slot);
+
+	if (slot->buffer == 0)
+	{
+		size_t allocsize = alignUp(size, STAGING_ALIGNMENT);
+
+		glGenBuffers(1, &slot->buffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+
+		if (persistent)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_PIXEL_UNPACK_BUFFER, allocsize, nullptr, flags);
+			slot->data = (uint8 *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, allocsize, flags);
+		}
+		else
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, allocsize, nullptr, GL_STREAM_DRAW);
+
+		slot->size = allocsize;
+	}
+	else
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+
+	// Without persistent mapping, the buffer stays mapped until the upload is
+	// issued. The GPU is done with it at this point, so there's no need for
+	// the driver to synchronize.
+	if (!persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		slot->data = (uint8 *) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, slot->size, flags);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (slot->data == nullptr)
+	{
+		destroySlot(slot);
+		return false;
+	}
+
+	return true;
+}
+
+void TextureUploadQueue::destroySlot(Slot *slot)
+{
+	if (slot->buffer != 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+
+		if (slot->data != nullptr)
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffers(1, &slot->buffer);
+	}
+
+	slot->sync.cleanup();
+	slot->buffer = 0;
+	slot->size = 0;
+	slot->data = nullptr;
+	slot->busy = false;
+}
+
+void TextureUploadQueue::issueUploads(bool wait)
+{
+	while (!uploads.empty())
+	{
+		Upload *upload = uploads.front();
+
+		{
+			love::thread::Lock lock(mutex);
+
+			if (!upload->copied && !wait)
+				break;
+
+			while (!upload->copied)
+				doneCond->wait(mutex);
+		}
+
+		uploads.pop_front();
+		issue(upload);
+		delete upload;
+	}
+}
+
+void TextureUploadQueue::issue(Upload *upload)
+{
+	Slot *slot = upload->slot;
+	love::image::ImageDataBase *source = upload->source.get();
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+
+	if (!persistent)
+	{
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		slot->data = nullptr;
+	}
+
+	// With a pixel unpack buffer bound, the data pointer passed to the upload
+	// is an offset into the buffer.
+	upload->image->uploadStaged(source->getFormat(), BUFFER_OFFSET(0), source->getSize(),
+	                            upload->level, upload->slice, upload->rect, upload->reloadMipmaps);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	slot->sync.fence();
+	slot->busy = false;
+}
+
+} // opengl
+} // graphics
+} // love
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "common/math.h"
+#include "image/ImageDataBase.h"
+#include "thread/threads.h"
+#include "OpenGL.h"
+#include "FenceSync.h"
+
+// C++
+#include <deque>
+
+namespace love
+{
+namespace graphics
+{
+namespace opengl
+{
+
+class Image;
+
+/**
+ * Uploads pixel data to textures without stalling the main thread. Pixels are
+ * copied into a ring of pixel unpack buffers by a background thread, then the
+ * main thread only issues the buffer-to-texture copy and fences the staging
+ * buffer so it can be reused once the GPU is done with it.
+ **/
+class TextureUploadQueue
+{
+public:
+
+	TextureUploadQueue();
+	~TextureUploadQueue();
+
+	/**
+	 * Queues an upload of d into the given region of the Image. Returns false
+	 * if no staging memory could be set up, in which case the caller should
+	 * upload synchronously instead.
+	 **/
+	bool enqueue(Image *image, love::image::ImageDataBase *d, int level, int slice, const Rect &rect, bool reloadmipmaps);
+
+	/**
+	 * Issues the texture copies of every upload whose staging data is ready,
+	 * and recycles staging buffers the GPU is done with. Must be called
+	 * regularly (once per frame) from the main thread.
+	 **/
+	void update();
+
+	/**
+	 * Blocks until every queued upload has been issued.
+	 **/
+	void flush();
+
+	/**
+	 * Whether the current context supports staged uploads.
+	 **/
+	static bool isSupported();
+
+private:
+
+	static const int MAX_SLOTS = 4;
+
+	struct Slot
+	{
+		GLuint buffer = 0;
+		size_t size = 0;
+		uint8 *data = nullptr;
+		bool busy = false;
+		FenceSync sync;
+	};
+
+	struct Upload
+	{
+		StrongRef<Image> image;
+		StrongRef<love::image::ImageDataBase> source;
+		int level;
+		int slice;
+		Rect rect;
+		bool reloadMipmaps;
+		Slot *slot;
+		bool copied;
+	};
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(TextureUploadQueue *queue);
+		void threadFunction() override;
+
+	private:
+
+		TextureUploadQueue *queue;
+	};
+
+	Slot *acquireSlot(size_t size);
+	bool mapSlot(Slot *slot, size_t size);
+	void destroySlot(Slot *slot);
+
+	// Issues uploads in order until one is found whose copy isn't done. If
+	// wait is true, blocks on that copy instead.
+	void issueUploads(bool wait);
+	void issue(Upload *upload);
+
+	bool persistent;
+
+	Slot slots[MAX_SLOTS];
+
+	// Uploads in submission order. Only touched on the main thread, except for
+	// Upload::copied which is guarded by mutex.
+	std::deque<Upload *> uploads;
+
+	// Uploads waiting for the worker to copy their pixels.
+	std::deque<Upload *> copyQueue;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef copyCond;
+	love::thread::ConditionalRef doneCond;
+
+	Worker *worker;
+	bool quit;
+
+}; // TextureUploadQueue
+
+} // opengl
+} // graphics
+} // love
@@ -20,6 +20,7 @@
 
 #include "wrap_Canvas.h"
 #include "Graphics.h"
+#include "wrap_Graphics.h"
 
 namespace love
 {
@@ -115,6 +116,45 @@ int w_Canvas_newImageData(lua_State *L)
 	return 1;
 }
 
+int w_Canvas_newImageDataAsync(lua_State *L)
+{
+	Canvas *canvas = luax_checkcanvas(L, 1);
+	Graphics *gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	int slice = 0;
+	int mipmap = 0;
+	Rect rect = {0, 0, canvas->getPixelWidth(), canvas->getPixelHeight()};
+
+	int startidx = 3;
+
+	if (canvas->getTextureType() != TEXTURE_2D)
+	{
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+		startidx++;
+	}
+
+	mipmap = (int) luaL_optinteger(L, startidx, 1) - 1;
+
+	if (!lua_isnoneornil(L, startidx + 1))
+	{
+		rect.x = (int) luaL_checkinteger(L, startidx + 1);
+		rect.y = (int) luaL_checkinteger(L, startidx + 2);
+		rect.w = (int) luaL_checkinteger(L, startidx + 3);
+		rect.h = (int) luaL_checkinteger(L, startidx + 4);
+	}
+
+	Graphics::ScreenshotInfo info;
+	info.async = true;
+	luax_checkscreenshotinfo(L, 2, info);
+
+	luax_catchexcept(L,
+		[&]() { gfx->readCanvasAsync(canvas, slice, mipmap, rect, info); },
+		[&](bool except) { if (except) info.callback(&info, nullptr, nullptr); }
+	);
+
+	return 0;
+}
+
 int w_Canvas_generateMipmaps(lua_State *L)
 {
 	Canvas *c = luax_checkcanvas(L, 1);
@@ -138,6 +178,7 @@ static const luaL_Reg w_Canvas_functions[] =
 	{ "getMSAA", w_Canvas_getMSAA },
 	{ "renderTo", w_Canvas_renderTo },
 	{ "newImageData", w_Canvas_newImageData },
+	{ "newImageDataAsync", w_Canvas_newImageDataAsync },
 	{ "generateMipmaps", w_Canvas_generateMipmaps },
 	{ "getMipmapMode", w_Canvas_getMipmapMode },
 	{ 0, 0 }
@@ -226,6 +226,102 @@ int w_Font_setFallbacks(lua_State *L)
 	return 0;
 }
 
+int w_Font_preload(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::Codepoints codepoints;
+
+	if (lua_istable(L, 2))
+	{
+		// A list of codepoints and {first, last} codepoint ranges.
+		for (int i = 1; i <= (int) luax_objlen(L, 2); i++)
+		{
+			lua_rawgeti(L, 2, i);
+
+			if (lua_istable(L, -1))
+			{
+				lua_rawgeti(L, -1, 1);
+				lua_rawgeti(L, -2, 2);
+				lua_Number first = luaL_checknumber(L, -2);
+				lua_Number last = luaL_checknumber(L, -1);
+				lua_pop(L, 2);
+
+				if (!(last >= first))
+					return luaL_error(L, "Invalid codepoint range: %f to %f.", first, last);
+
+				// Anything outside of Unicode's range can't have a glyph.
+				first = std::max(first, (lua_Number) 0);
+				last = std::min(last, (lua_Number) 0x10FFFF);
+
+				for (int64 g = (int64) first; g <= (int64) last; g++)
+					codepoints.push_back((uint32) g);
+			}
+			else
+				codepoints.push_back((uint32) luaL_checknumber(L, -1));
+
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		const char *str = luaL_checkstring(L, 2);
+		luax_catchexcept(L, [&](){ Font::getCodepointsFromString(str, codepoints); });
+	}
+
+	bool async = false;
+
+	if (!lua_isnoneornil(L, 3))
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		async = luax_boolflag(L, 3, "async", false);
+	}
+
+	luax_catchexcept(L, [&](){ t->preload(codepoints, async); });
+	return 0;
+}
+
+int w_Font_isPreloading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isPreloading());
+	return 1;
+}
+
+int w_Font_saveGlyphCache(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_catchexcept(L, [&](){ t->saveGlyphCache(); });
+	return 0;
+}
+
+int w_Font_setLayoutCacheSize(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	lua_Integer size = luaL_checkinteger(L, 2);
+	if (size < 0)
+		return luaL_error(L, "Layout cache size must not be negative.");
+
+	t->setLayoutCacheSize((size_t) size);
+	return 0;
+}
+
+int w_Font_getLayoutCacheSize(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getLayoutCacheSize());
+	return 1;
+}
+
+int w_Font_getLayoutCacheStats(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::LayoutCacheStats stats = t->getLayoutCacheStats();
+	lua_pushnumber(L, (lua_Number) stats.hits);
+	lua_pushnumber(L, (lua_Number) stats.misses);
+	lua_pushinteger(L, (lua_Integer) stats.count);
+	return 3;
+}
+
 int w_Font_getDPIScale(lua_State *L)
 {
 	Font *t = luax_checkfont(L, 1);
@@ -247,6 +343,12 @@ static const luaL_Reg w_Font_functions[] =
 	{ "getBaseline", w_Font_getBaseline },
 	{ "hasGlyphs", w_Font_hasGlyphs },
 	{ "setFallbacks", w_Font_setFallbacks },
+	{ "preload", w_Font_preload },
+	{ "isPreloading", w_Font_isPreloading },
+	{ "saveGlyphCache", w_Font_saveGlyphCache },
+	{ "setLayoutCacheSize", w_Font_setLayoutCacheSize },
+	{ "getLayoutCacheSize", w_Font_getLayoutCacheSize },
+	{ "getLayoutCacheStats", w_Font_getLayoutCacheStats },
 	{ "getDPIScale", w_Font_getDPIScale },
 	{ 0, 0 }
 };
@@ -500,20 +500,18 @@ static void screenshotChannelCallback(const Graphics::ScreenshotInfo *info, love
 	}
 }
 
-int w_captureScreenshot(lua_State *L)
+void luax_checkscreenshotinfo(lua_State *L, int idx, Graphics::ScreenshotInfo &info)
 {
-	Graphics::ScreenshotInfo info;
-
-	if (lua_isfunction(L, 1))
+	if (lua_isfunction(L, idx))
 	{
-		lua_pushvalue(L, 1);
+		lua_pushvalue(L, idx);
 		info.data = luax_refif(L, LUA_TFUNCTION);
 		lua_pop(L, 1);
 		info.callback = screenshotFunctionCallback;
 	}
-	else if (lua_isstring(L, 1))
+	else if (lua_isstring(L, idx))
 	{
-		std::string filename = luax_checkstring(L, 1);
+		std::string filename = luax_checkstring(L, idx);
 		std::string ext;
 
 		size_t dotpos = filename.rfind('.');
@@ -525,7 +523,7 @@ int w_captureScreenshot(lua_State *L)
 
 		image::FormatHandler::EncodedFormat format;
 		if (!image::ImageData::getConstant(ext.c_str(), format))
-			return luax_enumerror(L, "encoded image format", image::ImageData::getConstants(format), ext.c_str());
+			luax_enumerror(L, "encoded image format", image::ImageData::getConstants(format), ext.c_str());
 
 		ScreenshotFileInfo *fileinfo = new ScreenshotFileInfo;
 		fileinfo->filename = filename;
@@ -534,15 +532,23 @@ int w_captureScreenshot(lua_State *L)
 		info.data = fileinfo;
 		info.callback = screenshotFileCallback;
 	}
-	else if (luax_istype(L, 1, love::thread::Channel::type))
+	else if (luax_istype(L, idx, love::thread::Channel::type))
 	{
-		auto *channel = love::thread::luax_checkchannel(L, 1);
+		auto *channel = love::thread::luax_checkchannel(L, idx);
 		channel->retain();
 		info.data = channel;
 		info.callback = screenshotChannelCallback;
 	}
 	else
-		return luax_typerror(L, 1, "function, string, or Channel");
+		luax_typerror(L, idx, "function, string, or Channel");
+}
+
+int w_captureScreenshot(lua_State *L)
+{
+	Graphics::ScreenshotInfo info;
+	info.async = luax_optboolean(L, 2, false);
+
+	luax_checkscreenshotinfo(L, 1, info);
 
 	luax_catchexcept(L,
 		[&]() { instance()->captureScreenshot(info); },
@@ -1000,7 +1006,7 @@ int w_newVolumeImage(lua_State *L)
 	return w__pushNewImage(L, slices, settings);
 }
 
-int w_newImage(lua_State *L)
+static int w__newImage(lua_State *L, bool async)
 {
 	luax_checkgraphicscreated(L);
 
@@ -1010,6 +1016,8 @@ int w_newImage(lua_State *L)
 	Image::Settings settings = w__optImageSettings(L, 2, dpiscaleset);
 	float *autodpiscale = dpiscaleset ? nullptr : &settings.dpiScale;
 
+	settings.asyncUpload = async;
+
 	if (lua_istable(L, 1))
 	{
 		int n = std::max(1, (int) luax_objlen(L, 1));
@@ -1036,6 +1044,16 @@ int w_newImage(lua_State *L)
 	return w__pushNewImage(L, slices, settings);
 }
 
+int w_newImage(lua_State *L)
+{
+	return w__newImage(L, false);
+}
+
+int w_newImageAsync(lua_State *L)
+{
+	return w__newImage(L, true);
+}
+
 int w_newQuad(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1775,6 +1793,18 @@ int w_getFont(lua_State *L)
 	return 1;
 }
 
+int w_setGlyphCacheEnabled(lua_State *L)
+{
+	Font::setGlyphCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isGlyphCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, Font::isGlyphCacheEnabled());
+	return 1;
+}
+
 int w_setColorMask(lua_State *L)
 {
 	Graphics::ColorMask mask;
@@ -2801,6 +2831,26 @@ int w_flushBatch(lua_State *)
 	return 0;
 }
 
+int w_updateParticleSystems(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float dt = (float) luaL_checknumber(L, 2);
+
+	int count = (int) luax_objlen(L, 1);
+	std::vector<ParticleSystem *> systems;
+	systems.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		systems.push_back(luax_checktype<ParticleSystem>(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ ParticleSystem::updateBatch(systems, dt); });
+	return 0;
+}
+
 int w_getStackDepth(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getStackDepth());
@@ -2914,6 +2964,7 @@ static const luaL_Reg functions[] =
 	{ "present", w_present },
 
 	{ "newImage", w_newImage },
+	{ "newImageAsync", w_newImageAsync },
 	{ "newArrayImage", w_newArrayImage },
 	{ "newVolumeImage", w_newVolumeImage },
 	{ "newCubeImage", w_newCubeImage },
@@ -2941,6 +2992,8 @@ static const luaL_Reg functions[] =
 	{ "setNewFont", w_setNewFont },
 	{ "setFont", w_setFont },
 	{ "getFont", w_getFont },
+	{ "setGlyphCacheEnabled", w_setGlyphCacheEnabled },
+	{ "isGlyphCacheEnabled", w_isGlyphCacheEnabled },
 
 	{ "setColorMask", w_setColorMask },
 	{ "getColorMask", w_getColorMask },
@@ -3017,6 +3070,8 @@ static const luaL_Reg functions[] =
 
 	{ "flushBatch", w_flushBatch },
 
+	{ "updateParticleSystems", w_updateParticleSystems },
+
 	{ "getStackDepth", w_getStackDepth },
 	{ "push", w_push },
 	{ "pop", w_pop },
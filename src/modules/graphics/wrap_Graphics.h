@@ -39,6 +39,12 @@ namespace love
 namespace graphics
 {
 
+/**
+ * Sets up the callback for a screenshot or readback destination: a function,
+ * a filename, or a Channel.
+ **/
+void luax_checkscreenshotinfo(lua_State *L, int idx, Graphics::ScreenshotInfo &info);
+
 extern "C" LOVE_EXPORT int luaopen_love_graphics(lua_State *L);
 
 } // graphics
@@ -45,7 +45,7 @@ int w_Image_isCompressed(lua_State *L)
 	return 1;
 }
 
-int w_Image_replacePixels(lua_State *L)
+static int w__replacePixels(lua_State *L, bool async)
 {
 	Image *i = luax_checkimage(L, 1);
 	love::image::ImageData *id = luax_checktype<love::image::ImageData>(L, 2);
@@ -70,15 +70,41 @@ int w_Image_replacePixels(lua_State *L)
 			reloadmipmaps = luax_optboolean(L, 7, reloadmipmaps);
 	}
 
-	luax_catchexcept(L, [&](){ i->replacePixels(id, slice, mipmap, x, y, reloadmipmaps); });
+	luax_catchexcept(L, [&]()
+	{
+		if (async)
+			i->replacePixelsAsync(id, slice, mipmap, x, y, reloadmipmaps);
+		else
+			i->replacePixels(id, slice, mipmap, x, y, reloadmipmaps);
+	});
+
 	return 0;
 }
 
+int w_Image_replacePixels(lua_State *L)
+{
+	return w__replacePixels(L, false);
+}
+
+int w_Image_replacePixelsAsync(lua_State *L)
+{
+	return w__replacePixels(L, true);
+}
+
+int w_Image_isReady(lua_State *L)
+{
+	Image *i = luax_checkimage(L, 1);
+	luax_pushboolean(L, i->isReady());
+	return 1;
+}
+
 static const luaL_Reg w_Image_functions[] =
 {
 	{ "isFormatLinear", w_Image_isFormatLinear },
 	{ "isCompressed", w_Image_isCompressed },
 	{ "replacePixels", w_Image_replacePixels },
+	{ "replacePixelsAsync", w_Image_replacePixelsAsync },
+	{ "isReady", w_Image_isReady },
 	{ 0, 0 }
 };
 
@@ -46,6 +46,27 @@ class FormatHandler : public love::Object
 		ENCODED_MAX_ENUM
 	};
 
+	// Per-row filter used by encoders that support one (PNG).
+	enum EncodeFilter
+	{
+		ENCODE_FILTER_NONE,
+		ENCODE_FILTER_SUB,
+		ENCODE_FILTER_UP,
+		ENCODE_FILTER_AVERAGE,
+		ENCODE_FILTER_PAETH,
+		ENCODE_FILTER_ADAPTIVE,
+		ENCODE_FILTER_MAX_ENUM
+	};
+
+	// Optional tuning parameters for encode(). Encoders ignore settings which
+	// don't apply to their format.
+	struct EncodeSettings
+	{
+		// zlib-style compression level in [0, 9], or -1 for the default.
+		int compression = -1;
+		EncodeFilter filter = ENCODE_FILTER_ADAPTIVE;
+	};
+
 	// Raw RGBA pixel data.
 	struct DecodedImage
 	{
@@ -87,7 +108,7 @@ class FormatHandler : public love::Object
 	/**
 	 * Encodes an image from raw pixel data into a particular format.
 	 **/
-	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
+	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format, const EncodeSettings &settings);
 
 	/**
 	 * Whether this format handler can parse the given Data into a
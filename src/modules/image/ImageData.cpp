@@ -19,10 +19,21 @@
  **/
 
 #include "ImageData.h"
+#include "ImageEncodeTask.h"
 #include "Image.h"
 #include "filesystem/Filesystem.h"
+#include "thread/parallel.h"
 
 #include <algorithm> // min/max
+#include <vector>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 using love::thread::Lock;
 
@@ -163,7 +174,7 @@ void ImageData::decode(Data *data)
 	pixelGetFunction = getPixelGetFunction(format);
 }
 
-love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile) const
+love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile, const FormatHandler::EncodeSettings &settings) const
 {
 	FormatHandler *encoder = nullptr;
 	FormatHandler::EncodedImage encodedimage;
@@ -192,7 +203,7 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	if (encoder != nullptr)
 	{
 		thread::Lock lock(mutex);
-		encodedimage = encoder->encode(rawimage, encodedFormat);
+		encodedimage = encoder->encode(rawimage, encodedFormat, settings);
 	}
 
 	if (encoder == nullptr || encodedimage.data == nullptr)
@@ -241,6 +252,19 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	return filedata;
 }
 
+ImageEncodeTask *ImageData::encodeAsync(FormatHandler::EncodedFormat encodedFormat, const char *filename, bool writefile, const FormatHandler::EncodeSettings &settings)
+{
+	ImageEncodeTask *task = new ImageEncodeTask(this, encodedFormat, filename, writefile, settings);
+
+	if (!task->start())
+	{
+		task->release();
+		throw love::Exception("Could not start the image encoding thread.");
+	}
+
+	return task;
+}
+
 size_t ImageData::getSize() const
 {
 	return size_t(getWidth() * getHeight()) * getPixelSize();
@@ -299,8 +323,8 @@ static void setPixelRG16(const Colorf &c, ImageData::Pixel *p)
 static void setPixelRGBA16(const Colorf &c, ImageData::Pixel *p)
 {
 	p->rgba16[0] = (uint16) (clamp01(c.r) * 65535.0f + 0.5f);
-	p->rgba16[1] = (uint16) (clamp01(c.b) * 65535.0f + 0.5f);
-	p->rgba16[2] = (uint16) (clamp01(c.g) * 65535.0f + 0.5f);
+	p->rgba16[1] = (uint16) (clamp01(c.g) * 65535.0f + 0.5f);
+	p->rgba16[2] = (uint16) (clamp01(c.b) * 65535.0f + 0.5f);
 	p->rgba16[3] = (uint16) (clamp01(c.a) * 65535.0f + 0.5f);
 }
 
@@ -650,23 +674,14 @@ static void pasteRGBA32FtoRGBA16F(Row src, Row dst, int w)
 		dst.f16[i] = float32to16(src.f32[i]);
 }
 
-void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh)
+// Clips a rectangle copied from (sx, sy) in a source image to (dx, dy) in a
+// destination image so it's inside both. Returns false if nothing is left.
+static bool clipRegion(int srcW, int srcH, int dstW, int dstH, int &dx, int &dy, int &sx, int &sy, int &sw, int &sh)
 {
-	PixelFormat dstformat = getFormat();
-	PixelFormat srcformat = src->getFormat();
-
-	int srcW = src->getWidth();
-	int srcH = src->getHeight();
-	int dstW = getWidth();
-	int dstH = getHeight();
-
-	size_t srcpixelsize = src->getPixelSize();
-	size_t dstpixelsize = getPixelSize();
-
 	// Check bounds; if the data ends up completely out of bounds, get out early.
 	if (sx >= srcW || sx + sw < 0 || sy >= srcH || sy + sh < 0
 			|| dx >= dstW || dx + sw < 0 || dy >= dstH || dy + sh < 0)
-		return;
+		return false;
 
 	// Normalize values to the inside of both images.
 	if (dx < 0)
@@ -706,6 +721,25 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	if (sy + sh > srcH)
 		sh = srcH - sy;
 
+	return sw > 0 && sh > 0;
+}
+
+void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh)
+{
+	PixelFormat dstformat = getFormat();
+	PixelFormat srcformat = src->getFormat();
+
+	int srcW = src->getWidth();
+	int srcH = src->getHeight();
+	int dstW = getWidth();
+	int dstH = getHeight();
+
+	size_t srcpixelsize = src->getPixelSize();
+	size_t dstpixelsize = getPixelSize();
+
+	if (!clipRegion(srcW, srcH, dstW, dstH, dx, dy, sx, sy, sw, sh))
+		return;
+
 	Lock lock2(src->mutex);
 	Lock lock1(mutex);
 
@@ -775,6 +809,392 @@ void ImageData::paste(ImageData *src, int dx, int dy, int sx, int sy, int sw, in
 	}
 }
 
+// Pixels per parallelFor range in the bulk operations below.
+static const int BULK_PIXELS_PER_RANGE = 16384;
+
+static int getBulkRowsPerRange(int w)
+{
+	return std::max(BULK_PIXELS_PER_RANGE / std::max(w, 1), 1);
+}
+
+// Decodes a row of pixels into RGBA floats.
+static void decodeRow(const uint8 *src, float *dst, int w, PixelFormat format, ImageData::PixelGetFunction getfunction)
+{
+	Row row = {(uint8 *) src};
+
+	switch (format)
+	{
+	case PIXELFORMAT_RGBA8:
+		for (int i = 0; i < w * 4; i++)
+			dst[i] = row.u8[i] * (1.0f / 255.0f);
+		break;
+	case PIXELFORMAT_RGBA16:
+		for (int i = 0; i < w * 4; i++)
+			dst[i] = row.u16[i] * (1.0f / 65535.0f);
+		break;
+	case PIXELFORMAT_RGBA32F:
+		memcpy(dst, src, w * 4 * sizeof(float));
+		break;
+	default:
+	{
+		size_t pixelsize = getPixelFormatSize(format);
+		Colorf c;
+		for (int x = 0; x < w; x++)
+		{
+			getfunction((const ImageData::Pixel *) (src + x * pixelsize), c);
+			dst[x * 4 + 0] = c.r;
+			dst[x * 4 + 1] = c.g;
+			dst[x * 4 + 2] = c.b;
+			dst[x * 4 + 3] = c.a;
+		}
+		break;
+	}
+	}
+}
+
+// Encodes a row of RGBA floats into pixels.
+static void encodeRow(const float *src, uint8 *dst, int w, PixelFormat format, ImageData::PixelSetFunction setfunction)
+{
+	Row row = {dst};
+
+	switch (format)
+	{
+	case PIXELFORMAT_RGBA8:
+		for (int i = 0; i < w * 4; i++)
+			row.u8[i] = (uint8) (clamp01(src[i]) * 255.0f + 0.5f);
+		break;
+	case PIXELFORMAT_RGBA16:
+		for (int i = 0; i < w * 4; i++)
+			row.u16[i] = (uint16) (clamp01(src[i]) * 65535.0f + 0.5f);
+		break;
+	case PIXELFORMAT_RGBA32F:
+		memcpy(dst, src, w * 4 * sizeof(float));
+		break;
+	default:
+	{
+		size_t pixelsize = getPixelFormatSize(format);
+		for (int x = 0; x < w; x++)
+		{
+			Colorf c(src[x * 4 + 0], src[x * 4 + 1], src[x * 4 + 2], src[x * 4 + 3]);
+			setfunction(c, (ImageData::Pixel *) (dst + x * pixelsize));
+		}
+		break;
+	}
+	}
+}
+
+// row = row * scale + offset, per component.
+static void transformRow(float *row, int w, const float scale[4], const float offset[4])
+{
+#if defined(LOVE_SIMD_SSE)
+	__m128 s = _mm_loadu_ps(scale);
+	__m128 o = _mm_loadu_ps(offset);
+	for (int x = 0; x < w; x++)
+	{
+		__m128 p = _mm_loadu_ps(&row[x * 4]);
+		_mm_storeu_ps(&row[x * 4], _mm_add_ps(_mm_mul_ps(p, s), o));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	float32x4_t s = vld1q_f32(scale);
+	float32x4_t o = vld1q_f32(offset);
+	for (int x = 0; x < w; x++)
+	{
+		float32x4_t p = vld1q_f32(&row[x * 4]);
+		vst1q_f32(&row[x * 4], vmlaq_f32(o, p, s));
+	}
+#else
+	for (int i = 0; i < w * 4; i++)
+		row[i] = row[i] * scale[i & 3] + offset[i & 3];
+#endif
+}
+
+// Blends a row of source pixels onto a row of destination pixels. Each mode
+// is dst = src * F + dst * G, where F and G depend on the source alpha.
+static void compositeRow(const float *src, float *dst, int w, ImageData::CompositeMode mode)
+{
+#if defined(LOVE_SIMD_SSE)
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (int x = 0; x < w; x++)
+	{
+		__m128 s = _mm_loadu_ps(&src[x * 4]);
+		__m128 d = _mm_loadu_ps(&dst[x * 4]);
+
+		// (a, a, a, a) and (a, a, a, 1).
+		__m128 sa = _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 3));
+		__m128 sa1 = _mm_shuffle_ps(sa, _mm_shuffle_ps(sa, one, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 0, 0));
+
+		__m128 result;
+		switch (mode)
+		{
+		case ImageData::COMPOSITE_ALPHA:
+		default:
+			result = _mm_add_ps(_mm_mul_ps(s, sa1), _mm_mul_ps(d, _mm_sub_ps(one, sa)));
+			break;
+		case ImageData::COMPOSITE_PREMULTIPLIED:
+			result = _mm_add_ps(s, _mm_mul_ps(d, _mm_sub_ps(one, sa)));
+			break;
+		case ImageData::COMPOSITE_ADD:
+			result = _mm_add_ps(_mm_mul_ps(s, sa1), d);
+			break;
+		case ImageData::COMPOSITE_MULTIPLY:
+			result = _mm_mul_ps(s, d);
+			break;
+		}
+
+		_mm_storeu_ps(&dst[x * 4], result);
+	}
+#elif defined(LOVE_SIMD_NEON)
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	for (int x = 0; x < w; x++)
+	{
+		float32x4_t s = vld1q_f32(&src[x * 4]);
+		float32x4_t d = vld1q_f32(&dst[x * 4]);
+
+		float32x4_t sa = vdupq_n_f32(src[x * 4 + 3]);
+		float32x4_t sa1 = vsetq_lane_f32(1.0f, sa, 3);
+
+		float32x4_t result;
+		switch (mode)
+		{
+		case ImageData::COMPOSITE_ALPHA:
+		default:
+			result = vmlaq_f32(vmulq_f32(s, sa1), d, vsubq_f32(one, sa));
+			break;
+		case ImageData::COMPOSITE_PREMULTIPLIED:
+			result = vmlaq_f32(s, d, vsubq_f32(one, sa));
+			break;
+		case ImageData::COMPOSITE_ADD:
+			result = vmlaq_f32(d, s, sa1);
+			break;
+		case ImageData::COMPOSITE_MULTIPLY:
+			result = vmulq_f32(s, d);
+			break;
+		}
+
+		vst1q_f32(&dst[x * 4], result);
+	}
+#else
+	for (int x = 0; x < w; x++)
+	{
+		const float *s = &src[x * 4];
+		float *d = &dst[x * 4];
+		float sa = s[3];
+
+		for (int i = 0; i < 4; i++)
+		{
+			float sf = i < 3 ? s[i] * sa : s[i];
+
+			switch (mode)
+			{
+			case ImageData::COMPOSITE_ALPHA:
+			default:
+				d[i] = sf + d[i] * (1.0f - sa);
+				break;
+			case ImageData::COMPOSITE_PREMULTIPLIED:
+				d[i] = s[i] + d[i] * (1.0f - sa);
+				break;
+			case ImageData::COMPOSITE_ADD:
+				d[i] = sf + d[i];
+				break;
+			case ImageData::COMPOSITE_MULTIPLY:
+				d[i] = s[i] * d[i];
+				break;
+			}
+		}
+	}
+#endif
+}
+
+static void premultiplyRow(float *row, int w)
+{
+#if defined(LOVE_SIMD_SSE)
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (int x = 0; x < w; x++)
+	{
+		__m128 p = _mm_loadu_ps(&row[x * 4]);
+		__m128 a = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+		__m128 a1 = _mm_shuffle_ps(a, _mm_shuffle_ps(a, one, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 0, 0));
+		_mm_storeu_ps(&row[x * 4], _mm_mul_ps(p, a1));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (int x = 0; x < w; x++)
+	{
+		float32x4_t p = vld1q_f32(&row[x * 4]);
+		float32x4_t a1 = vsetq_lane_f32(1.0f, vdupq_n_f32(row[x * 4 + 3]), 3);
+		vst1q_f32(&row[x * 4], vmulq_f32(p, a1));
+	}
+#else
+	for (int x = 0; x < w; x++)
+	{
+		float a = row[x * 4 + 3];
+		row[x * 4 + 0] *= a;
+		row[x * 4 + 1] *= a;
+		row[x * 4 + 2] *= a;
+	}
+#endif
+}
+
+static void unpremultiplyRow(float *row, int w)
+{
+	for (int x = 0; x < w; x++)
+	{
+		float a = row[x * 4 + 3];
+		if (a <= 0.0f)
+			continue;
+
+		float inva = 1.0f / a;
+		row[x * 4 + 0] *= inva;
+		row[x * 4 + 1] *= inva;
+		row[x * 4 + 2] *= inva;
+	}
+}
+
+void ImageData::checkRegion(int x, int y, int w, int h) const
+{
+	if (w <= 0 || h <= 0 || !(inside(x, y) && inside(x + w - 1, y + h - 1)))
+		throw love::Exception("Invalid rectangle dimensions.");
+}
+
+void ImageData::fill(const Colorf &c, int x, int y, int w, int h)
+{
+	checkRegion(x, y, w, h);
+
+	if (pixelSetFunction == nullptr)
+		throw love::Exception("Unhandled pixel format %d in ImageData::fill", format);
+
+	size_t pixelsize = getPixelSize();
+
+	Pixel p;
+	pixelSetFunction(c, &p);
+
+	std::vector<uint8> filledrow(w * pixelsize);
+	for (int i = 0; i < w; i++)
+		memcpy(&filledrow[i * pixelsize], &p, pixelsize);
+
+	Lock lock(mutex);
+
+	love::thread::parallelFor(h, getBulkRowsPerRange(w), [&](int begin, int end)
+	{
+		for (int row = begin; row < end; row++)
+			memcpy(data + ((y + row) * width + x) * pixelsize, filledrow.data(), w * pixelsize);
+	});
+}
+
+void ImageData::mapRows(int x, int y, int w, int h, const std::function<void(float *, int)> &func)
+{
+	checkRegion(x, y, w, h);
+
+	if (pixelSetFunction == nullptr || pixelGetFunction == nullptr)
+		throw love::Exception("Unhandled pixel format %d in ImageData", format);
+
+	size_t pixelsize = getPixelSize();
+
+	Lock lock(mutex);
+
+	love::thread::parallelFor(h, getBulkRowsPerRange(w), [&](int begin, int end)
+	{
+		std::vector<float> row(w * 4);
+
+		for (int i = begin; i < end; i++)
+		{
+			uint8 *pixels = data + ((y + i) * width + x) * pixelsize;
+			decodeRow(pixels, row.data(), w, format, pixelGetFunction);
+			func(row.data(), w);
+			encodeRow(row.data(), pixels, w, format, pixelSetFunction);
+		}
+	});
+}
+
+void ImageData::transformChannels(const Colorf &scale, const Colorf &offset, int x, int y, int w, int h)
+{
+	const float s[4] = {scale.r, scale.g, scale.b, scale.a};
+	const float o[4] = {offset.r, offset.g, offset.b, offset.a};
+
+	mapRows(x, y, w, h, [&](float *row, int rowwidth) { transformRow(row, rowwidth, s, o); });
+}
+
+void ImageData::premultiplyAlpha(int x, int y, int w, int h)
+{
+	mapRows(x, y, w, h, premultiplyRow);
+}
+
+void ImageData::unpremultiplyAlpha(int x, int y, int w, int h)
+{
+	mapRows(x, y, w, h, unpremultiplyRow);
+}
+
+void ImageData::composite(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh, CompositeMode mode)
+{
+	if (!clipRegion(src->getWidth(), src->getHeight(), getWidth(), getHeight(), dx, dy, sx, sy, sw, sh))
+		return;
+
+	if (pixelSetFunction == nullptr || pixelGetFunction == nullptr || src->pixelGetFunction == nullptr)
+		throw love::Exception("Unhandled pixel format in ImageData::composite");
+
+	// Rows are processed in parallel, so they can't overlap with each other.
+	StrongRef<ImageData> srccopy;
+	if (src == this)
+	{
+		srccopy.set(clone(), Acquire::NORETAIN);
+		src = srccopy;
+	}
+
+	Lock lock2(src->mutex);
+	Lock lock1(mutex);
+
+	size_t srcpixelsize = src->getPixelSize();
+	size_t dstpixelsize = getPixelSize();
+
+	love::thread::parallelFor(sh, getBulkRowsPerRange(sw), [&](int begin, int end)
+	{
+		std::vector<float> srcrow(sw * 4);
+		std::vector<float> dstrow(sw * 4);
+
+		for (int i = begin; i < end; i++)
+		{
+			const uint8 *s = src->data + ((sy + i) * src->width + sx) * srcpixelsize;
+			uint8 *d = data + ((dy + i) * width + dx) * dstpixelsize;
+
+			decodeRow(s, srcrow.data(), sw, src->format, src->pixelGetFunction);
+			decodeRow(d, dstrow.data(), sw, format, pixelGetFunction);
+			compositeRow(srcrow.data(), dstrow.data(), sw, mode);
+			encodeRow(dstrow.data(), d, sw, format, pixelSetFunction);
+		}
+	});
+}
+
+ImageData *ImageData::convert(PixelFormat dstformat) const
+{
+	if (!validPixelFormat(dstformat))
+		throw love::Exception("Unsupported pixel format for ImageData");
+
+	StrongRef<ImageData> dst(new ImageData(width, height, dstformat), Acquire::NORETAIN);
+
+	Lock lock(mutex);
+
+	size_t srcpixelsize = getPixelSize();
+	size_t dstpixelsize = dst->getPixelSize();
+
+	if (dstformat == format)
+		memcpy(dst->data, data, getSize());
+	else
+	{
+		love::thread::parallelFor(height, getBulkRowsPerRange(width), [&](int begin, int end)
+		{
+			std::vector<float> row(width * 4);
+
+			for (int i = begin; i < end; i++)
+			{
+				decodeRow(data + i * width * srcpixelsize, row.data(), width, format, pixelGetFunction);
+				encodeRow(row.data(), dst->data + i * width * dstpixelsize, width, dstformat, dst->pixelSetFunction);
+			}
+		});
+	}
+
+	dst->retain();
+	return dst;
+}
+
 love::thread::Mutex *ImageData::getMutex() const
 {
 	return mutex;
@@ -893,6 +1313,36 @@ std::vector<std::string> ImageData::getConstants(FormatHandler::EncodedFormat)
 	return encodedFormats.getNames();
 }
 
+bool ImageData::getConstant(const char *in, FormatHandler::EncodeFilter &out)
+{
+	return encodeFilters.find(in, out);
+}
+
+bool ImageData::getConstant(FormatHandler::EncodeFilter in, const char *&out)
+{
+	return encodeFilters.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(FormatHandler::EncodeFilter)
+{
+	return encodeFilters.getNames();
+}
+
+bool ImageData::getConstant(const char *in, CompositeMode &out)
+{
+	return compositeModes.find(in, out);
+}
+
+bool ImageData::getConstant(CompositeMode in, const char *&out)
+{
+	return compositeModes.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(CompositeMode)
+{
+	return compositeModes.getNames();
+}
+
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry ImageData::encodedFormatEntries[] =
 {
 	{"tga", FormatHandler::ENCODED_TGA},
@@ -901,5 +1351,27 @@ StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry
 
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> ImageData::encodedFormats(ImageData::encodedFormatEntries, sizeof(ImageData::encodedFormatEntries));
 
+StringMap<FormatHandler::EncodeFilter, FormatHandler::ENCODE_FILTER_MAX_ENUM>::Entry ImageData::encodeFilterEntries[] =
+{
+	{"none", FormatHandler::ENCODE_FILTER_NONE},
+	{"sub", FormatHandler::ENCODE_FILTER_SUB},
+	{"up", FormatHandler::ENCODE_FILTER_UP},
+	{"average", FormatHandler::ENCODE_FILTER_AVERAGE},
+	{"paeth", FormatHandler::ENCODE_FILTER_PAETH},
+	{"adaptive", FormatHandler::ENCODE_FILTER_ADAPTIVE},
+};
+
+StringMap<FormatHandler::EncodeFilter, FormatHandler::ENCODE_FILTER_MAX_ENUM> ImageData::encodeFilters(ImageData::encodeFilterEntries, sizeof(ImageData::encodeFilterEntries));
+
+StringMap<ImageData::CompositeMode, ImageData::COMPOSITE_MAX_ENUM>::Entry ImageData::compositeModeEntries[] =
+{
+	{"alpha", COMPOSITE_ALPHA},
+	{"premultiplied", COMPOSITE_PREMULTIPLIED},
+	{"add", COMPOSITE_ADD},
+	{"multiply", COMPOSITE_MULTIPLY},
+};
+
+StringMap<ImageData::CompositeMode, ImageData::COMPOSITE_MAX_ENUM> ImageData::compositeModes(ImageData::compositeModeEntries, sizeof(ImageData::compositeModeEntries));
+
 } // image
 } // love
@@ -32,6 +32,9 @@
 #include "ImageDataBase.h"
 #include "FormatHandler.h"
 
+// C++
+#include <functional>
+
 using love::thread::Mutex;
 
 namespace love
@@ -39,6 +42,8 @@ namespace love
 namespace image
 {
 
+class ImageEncodeTask;
+
 /**
  * Represents raw pixel data.
  **/
@@ -56,6 +61,16 @@ class ImageData : public ImageDataBase
 		uint32  packed32;
 	};
 
+	// How ImageData::composite combines source and destination pixels.
+	enum CompositeMode
+	{
+		COMPOSITE_ALPHA,
+		COMPOSITE_PREMULTIPLIED,
+		COMPOSITE_ADD,
+		COMPOSITE_MULTIPLY,
+		COMPOSITE_MAX_ENUM
+	};
+
 	typedef void (*PixelSetFunction)(const Colorf &c, Pixel *p);
 	typedef void (*PixelGetFunction)(const Pixel *p, Colorf &c);
 
@@ -103,12 +118,50 @@ class ImageData : public ImageDataBase
 	void getPixel(int x, int y, Colorf &c) const;
 	Colorf getPixel(int x, int y) const;
 
+	/**
+	 * Sets every pixel in a rectangle to the given color.
+	 **/
+	void fill(const Colorf &c, int x, int y, int w, int h);
+
+	/**
+	 * Multiplies each component of the pixels in a rectangle by the matching
+	 * component of scale, then adds the matching component of offset.
+	 **/
+	void transformChannels(const Colorf &scale, const Colorf &offset, int x, int y, int w, int h);
+
+	/**
+	 * Multiplies (or divides) the RGB components of the pixels in a rectangle
+	 * by their alpha component.
+	 **/
+	void premultiplyAlpha(int x, int y, int w, int h);
+	void unpremultiplyAlpha(int x, int y, int w, int h);
+
+	/**
+	 * Like paste, but blends the source pixels with the destination pixels
+	 * using the given mode. Any pair of pixel formats is supported.
+	 **/
+	void composite(ImageData *src, int dx, int dy, int sx, int sy, int sw, int sh, CompositeMode mode);
+
+	/**
+	 * Creates a copy of this ImageData with a different pixel format.
+	 **/
+	ImageData *convert(PixelFormat format) const;
+
 	/**
 	 * Encodes raw pixel data into a given format.
 	 * @param f The file to save the encoded image data to.
 	 * @param format The format of the encoded data.
+	 * @param settings Compression tuning, for formats which support it.
+	 **/
+	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile,
+	                                   const FormatHandler::EncodeSettings &settings = FormatHandler::EncodeSettings()) const;
+
+	/**
+	 * Starts encoding on a background thread. The ImageData is kept alive and
+	 * locked while the encode runs.
 	 **/
-	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
+	ImageEncodeTask *encodeAsync(FormatHandler::EncodedFormat format, const char *filename, bool writefile,
+	                             const FormatHandler::EncodeSettings &settings);
 
 	love::thread::Mutex *getMutex() const;
 
@@ -133,8 +186,23 @@ class ImageData : public ImageDataBase
 	static bool getConstant(FormatHandler::EncodedFormat in, const char *&out);
 	static std::vector<std::string> getConstants(FormatHandler::EncodedFormat);
 
+	static bool getConstant(const char *in, FormatHandler::EncodeFilter &out);
+	static bool getConstant(FormatHandler::EncodeFilter in, const char *&out);
+	static std::vector<std::string> getConstants(FormatHandler::EncodeFilter);
+
+	static bool getConstant(const char *in, CompositeMode &out);
+	static bool getConstant(CompositeMode in, const char *&out);
+	static std::vector<std::string> getConstants(CompositeMode);
+
 private:
 
+	// Throws if the rectangle isn't fully inside the ImageData.
+	void checkRegion(int x, int y, int w, int h) const;
+
+	// Decodes each row of a rectangle to RGBA floats, calls func on it, and
+	// encodes the result back. Rows are processed in parallel.
+	void mapRows(int x, int y, int w, int h, const std::function<void(float *, int)> &func);
+
 	// Create imagedata. Initialize with data if not null.
 	void create(int width, int height, PixelFormat format, void *data = nullptr);
 
@@ -156,6 +224,12 @@ class ImageData : public ImageDataBase
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry encodedFormatEntries[];
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> encodedFormats;
 
+	static StringMap<FormatHandler::EncodeFilter, FormatHandler::ENCODE_FILTER_MAX_ENUM>::Entry encodeFilterEntries[];
+	static StringMap<FormatHandler::EncodeFilter, FormatHandler::ENCODE_FILTER_MAX_ENUM> encodeFilters;
+
+	static StringMap<CompositeMode, COMPOSITE_MAX_ENUM>::Entry compositeModeEntries[];
+	static StringMap<CompositeMode, COMPOSITE_MAX_ENUM> compositeModes;
+
 }; // ImageData
 
 } // image
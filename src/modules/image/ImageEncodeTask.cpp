@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ImageEncodeTask.h"
+#include "ImageData.h"
+
+namespace love
+{
+namespace image
+{
+
+love::Type ImageEncodeTask::type("ImageEncodeTask", &Threadable::type);
+
+ImageEncodeTask::ImageEncodeTask(ImageData *imageData, FormatHandler::EncodedFormat format, const std::string &filename, bool writefile, const FormatHandler::EncodeSettings &settings)
+	: imageData(imageData)
+	, format(format)
+	, filename(filename)
+	, writefile(writefile)
+	, settings(settings)
+	, complete(false)
+{
+	threadName = "ImageEncodeTask";
+}
+
+ImageEncodeTask::~ImageEncodeTask()
+{
+	// No wait() here: the thread keeps a reference to us until it's done, so
+	// the last release can happen on the thread itself.
+}
+
+void ImageEncodeTask::threadFunction()
+{
+	love::filesystem::FileData *result = nullptr;
+	std::string err;
+
+	try
+	{
+		result = imageData->encode(format, filename.c_str(), writefile, settings);
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+	}
+
+	love::thread::Lock lock(mutex);
+
+	fileData.set(result, Acquire::NORETAIN);
+	error = err;
+	complete = true;
+
+	cond->broadcast();
+}
+
+bool ImageEncodeTask::isComplete() const
+{
+	love::thread::Lock lock(mutex);
+	return complete;
+}
+
+void ImageEncodeTask::waitComplete()
+{
+	love::thread::Lock lock(mutex);
+	while (!complete)
+		cond->wait(mutex);
+}
+
+love::filesystem::FileData *ImageEncodeTask::getFileData() const
+{
+	love::thread::Lock lock(mutex);
+	return fileData.get();
+}
+
+std::string ImageEncodeTask::getError() const
+{
+	love::thread::Lock lock(mutex);
+	return error;
+}
+
+} // image
+} // love
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "filesystem/FileData.h"
+#include "thread/threads.h"
+#include "FormatHandler.h"
+
+// C++
+#include <string>
+
+namespace love
+{
+namespace image
+{
+
+class ImageData;
+
+/**
+ * Encodes an ImageData on a background thread. The result can be polled or
+ * waited on from any thread, and the task itself can be sent through a
+ * Channel.
+ **/
+class ImageEncodeTask : public love::thread::Threadable
+{
+public:
+
+	static love::Type type;
+
+	ImageEncodeTask(ImageData *imageData, FormatHandler::EncodedFormat format, const std::string &filename, bool writefile, const FormatHandler::EncodeSettings &settings);
+	virtual ~ImageEncodeTask();
+
+	// Implements Threadable.
+	void threadFunction() override;
+
+	/**
+	 * Whether the encode has finished, successfully or not.
+	 **/
+	bool isComplete() const;
+
+	/**
+	 * Blocks until the encode has finished.
+	 **/
+	void waitComplete();
+
+	/**
+	 * Gets the encoded file, or null if the encode hasn't finished or failed.
+	 **/
+	love::filesystem::FileData *getFileData() const;
+
+	/**
+	 * Gets the error message if the encode failed.
+	 **/
+	std::string getError() const;
+
+private:
+
+	StrongRef<ImageData> imageData;
+	FormatHandler::EncodedFormat format;
+	std::string filename;
+	bool writefile;
+	FormatHandler::EncodeSettings settings;
+
+	StrongRef<love::filesystem::FileData> fileData;
+	std::string error;
+	bool complete;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // ImageEncodeTask
+
+} // image
+} // love
@@ -23,6 +23,7 @@
 // LOVE
 #include "common/Exception.h"
 #include "common/math.h"
+#include "thread/parallel.h"
 
 // LodePNG
 #include "lodepng/lodepng.h"
@@ -32,9 +33,12 @@
 
 // C++
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 // C
 #include <cstdlib>
+#include <cstring>
 
 namespace love
 {
@@ -97,35 +101,160 @@ static unsigned zlibDecompress(unsigned char **out, size_t *outsize, const unsig
 	return 0; // Success.
 }
 
-// Custom PNG compression function for LodePNG, using zlib.
-static unsigned zlibCompress(unsigned char **out, size_t *outsize, const unsigned char *in,
-                             size_t insize, const LodePNGCompressSettings* /*settings*/)
+// Rows are deflated in independent groups of at least this many bytes. Each
+// group is primed with the tail of the previous one, so the compression ratio
+// stays close to a single-stream encode.
+static const size_t PNG_BYTES_PER_GROUP = 256 * 1024;
+static const size_t PNG_DICTIONARY_SIZE = 32 * 1024;
+static const size_t PNG_MAX_IDAT_SIZE = 1024 * 1024;
+
+static inline uint8 paethPredictor(int a, int b, int c)
 {
-	// Get the maximum compressed size of the data.
-	uLongf outdatasize = compressBound(insize);
+	int p = a + b - c;
+	int pa = abs(p - a);
+	int pb = abs(p - b);
+	int pc = abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return (uint8) a;
+	else if (pb <= pc)
+		return (uint8) b;
+	else
+		return (uint8) c;
+}
 
-	// LodePNG uses malloc, realloc, and free.
-	unsigned char *outdata = (unsigned char *) malloc(outdatasize);
+// Writes the filter type byte followed by the filtered scanline to out.
+// prev is null for the first row of the image.
+static void filterRow(uint8 *out, const uint8 *cur, const uint8 *prev, size_t rowsize, size_t bpp, int filter)
+{
+	out[0] = (uint8) filter;
+	out++;
 
-	if (!outdata)
-		return 83; // "Memory allocation failed" error code for LodePNG.
+	switch (filter)
+	{
+	case 0:
+		memcpy(out, cur, rowsize);
+		break;
+	case 1:
+		for (size_t i = 0; i < rowsize; i++)
+			out[i] = cur[i] - (i >= bpp ? cur[i - bpp] : 0);
+		break;
+	case 2:
+		for (size_t i = 0; i < rowsize; i++)
+			out[i] = cur[i] - (prev ? prev[i] : 0);
+		break;
+	case 3:
+		for (size_t i = 0; i < rowsize; i++)
+		{
+			int a = i >= bpp ? cur[i - bpp] : 0;
+			int b = prev ? prev[i] : 0;
+			out[i] = cur[i] - (uint8) ((a + b) >> 1);
+		}
+		break;
+	case 4:
+		for (size_t i = 0; i < rowsize; i++)
+		{
+			int a = i >= bpp ? cur[i - bpp] : 0;
+			int b = prev ? prev[i] : 0;
+			int c = (i >= bpp && prev) ? prev[i - bpp] : 0;
+			out[i] = cur[i] - paethPredictor(a, b, c);
+		}
+		break;
+	default:
+		break;
+	}
+}
 
-	// Use zlib to compress the PNG data.
-	int status = compress(outdata, &outdatasize, in, insize);
+// Picks the filter with the smallest sum of absolute (signed) differences,
+// the same heuristic LodePNG and libpng use by default.
+static void filterRowAdaptive(uint8 *out, uint8 *scratch, const uint8 *cur, const uint8 *prev, size_t rowsize, size_t bpp)
+{
+	size_t bestsum = std::numeric_limits<size_t>::max();
 
-	if (status != Z_OK)
+	for (int filter = 0; filter < 5; filter++)
 	{
-		free(outdata);
-		return 10000; // "Unknown error code" for LodePNG.
+		uint8 *dst = filter == 0 ? out : scratch;
+		filterRow(dst, cur, prev, rowsize, bpp, filter);
+
+		size_t sum = 0;
+		for (size_t i = 1; i <= rowsize; i++)
+			sum += (size_t) abs((int) (int8) dst[i]);
+
+		if (sum < bestsum)
+		{
+			bestsum = sum;
+			if (dst != out)
+				memcpy(out, dst, rowsize + 1);
+		}
 	}
+}
 
-	if (out != nullptr)
-		*out = outdata;
+static void writeUint32BE(uint8 *dst, uint32 v)
+{
+	dst[0] = (uint8) (v >> 24);
+	dst[1] = (uint8) (v >> 16);
+	dst[2] = (uint8) (v >> 8);
+	dst[3] = (uint8) v;
+}
 
-	if (outsize != nullptr)
-		*outsize = (size_t) outdatasize;
+static uint8 *writeChunk(uint8 *dst, const char *type, const uint8 *data, size_t size)
+{
+	writeUint32BE(dst, (uint32) size);
+	memcpy(dst + 4, type, 4);
+	if (size > 0)
+		memcpy(dst + 8, data, size);
 
-	return 0; // Success.
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, dst + 4, (uInt) (size + 4));
+	writeUint32BE(dst + 8 + size, (uint32) crc);
+
+	return dst + 12 + size;
+}
+
+// Deflates one group of filtered scanlines as a raw (headerless) deflate
+// segment. Segments other than the last end on a full flush, so they can be
+// concatenated into a single zlib stream.
+static void deflateGroup(std::vector<uint8> &out, const uint8 *in, size_t size, const uint8 *dict, size_t dictsize, int level, bool last)
+{
+	z_stream stream;
+	memset(&stream, 0, sizeof(z_stream));
+
+	if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw love::Exception("Could not encode PNG image (zlib initialization failed)");
+
+	if (dictsize > 0)
+		deflateSetDictionary(&stream, dict, (uInt) dictsize);
+
+	out.resize(deflateBound(&stream, (uLong) size) + 16);
+
+	stream.next_in = (Bytef *) in;
+	stream.avail_in = (uInt) size;
+
+	int flush = last ? Z_FINISH : Z_FULL_FLUSH;
+	int status = Z_OK;
+
+	while (true)
+	{
+		size_t written = stream.total_out;
+		stream.next_out = out.data() + written;
+		stream.avail_out = (uInt) (out.size() - written);
+
+		status = deflate(&stream, flush);
+
+		if (status == Z_STREAM_ERROR)
+			break;
+
+		if (last ? status == Z_STREAM_END : stream.avail_out > 0)
+			break;
+
+		out.resize(out.size() * 2);
+	}
+
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	if (status == Z_STREAM_ERROR)
+		throw love::Exception("Could not encode PNG image (zlib error)");
 }
 
 bool PNGHandler::canDecode(Data *data)
@@ -199,60 +328,167 @@ PNGHandler::DecodedImage PNGHandler::decode(Data *fdata)
 	return img;
 }
 
-FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat)
+FormatHandler::EncodedImage PNGHandler::encode(const DecodedImage &img, EncodedFormat encodedFormat, const EncodeSettings &settings)
 {
 	if (!canEncode(img.format, encodedFormat))
 		throw love::Exception("PNG encoder cannot encode to non-PNG format.");
 
-	EncodedImage encimg;
-
-	lodepng::State state;
+	int level = settings.compression < 0 ? Z_DEFAULT_COMPRESSION : std::min(settings.compression, 9);
+	int bitdepth = img.format == PIXELFORMAT_RGBA16 ? 16 : 8;
+	size_t bpp = bitdepth / 2;
+	size_t rowsize = (size_t) img.width * bpp;
+	size_t filteredrowsize = rowsize + 1;
 
-	state.info_raw.colortype = LCT_RGBA;
-	state.info_raw.bitdepth = img.format == PIXELFORMAT_RGBA16 ? 16 : 8;
+	size_t rowspergroup = std::max<size_t>(1, PNG_BYTES_PER_GROUP / filteredrowsize);
+	int groupcount = (int) ((img.height + rowspergroup - 1) / rowspergroup);
 
-	state.info_png.color.colortype = LCT_RGBA;
-	state.info_png.color.bitdepth = state.info_raw.bitdepth;
+	std::vector<uint8> filtered;
+	std::vector<std::vector<uint8>> groups;
 
-	state.encoder.zlibsettings.custom_zlib = zlibCompress;
+	try
+	{
+		filtered.resize(filteredrowsize * img.height);
+		groups.resize(groupcount);
+	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
 
-	const uint8 *data = img.data;
-	uint16 *swappeddata = nullptr;
+	// Filters are computed from the unfiltered bytes of the previous row, so
+	// every row can be filtered independently.
+	love::thread::parallelFor(img.height, (int) rowspergroup, [&](int begin, int end)
+	{
+		std::vector<uint8> scratch(filteredrowsize);
+		std::vector<uint8> swapped;
 
-	// LodePNG expects big-endian raw pixel data when encoding a 16 bit image.
+		// PNG stores 16 bit samples as big-endian.
+		bool swap = false;
 #ifndef LOVE_BIG_ENDIAN
-	if (state.info_raw.bitdepth == 16)
-	{
-		try
+		swap = bitdepth == 16;
+#endif
+		if (swap)
+			swapped.resize(rowsize * 2);
+
+		for (int y = begin; y < end; y++)
 		{
-			swappeddata = new uint16[img.size / sizeof(uint16)];
+			const uint8 *cur = img.data + y * rowsize;
+			const uint8 *prev = y > 0 ? cur - rowsize : nullptr;
+
+			if (swap)
+			{
+				uint16 *dst = (uint16 *) swapped.data();
+				const uint16 *src = (const uint16 *) (prev != nullptr ? prev : cur);
+				size_t count = rowsize / sizeof(uint16);
+
+				for (size_t i = 0; i < count; i++)
+					dst[i] = swapuint16(src[i]);
+
+				src = (const uint16 *) cur;
+				for (size_t i = 0; i < count; i++)
+					dst[count + i] = swapuint16(src[i]);
+
+				prev = prev != nullptr ? swapped.data() : nullptr;
+				cur = swapped.data() + rowsize;
+			}
+
+			uint8 *out = filtered.data() + y * filteredrowsize;
+
+			if (settings.filter == ENCODE_FILTER_ADAPTIVE)
+				filterRowAdaptive(out, scratch.data(), cur, prev, rowsize, bpp);
+			else
+				filterRow(out, cur, prev, rowsize, bpp, (int) settings.filter);
 		}
-		catch (std::exception &)
+	});
+
+	love::thread::parallelFor(groupcount, 1, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
 		{
-			throw love::Exception("Out of memory.");
+			size_t offset = i * rowspergroup * filteredrowsize;
+			size_t size = std::min(rowspergroup * filteredrowsize, filtered.size() - offset);
+			size_t dictsize = std::min(offset, PNG_DICTIONARY_SIZE);
+
+			deflateGroup(groups[i], filtered.data() + offset, size, filtered.data() + offset - dictsize,
+			             dictsize, level, i == groupcount - 1);
 		}
+	});
 
-		const uint16 *rawdata = (const uint16 *) img.data;
-		size_t numpixelcomponents = img.size / sizeof(uint16);
+	// zlib stream header. The FLEVEL bits are informational only.
+	int flevel = 2;
+	if (level >= 0 && level <= 1)
+		flevel = 0;
+	else if (level >= 2 && level <= 5)
+		flevel = 1;
+	else if (level >= 7)
+		flevel = 3;
 
-		for (size_t i = 0; i < numpixelcomponents; i++)
-			swappeddata[i] = swapuint16(rawdata[i]);
+	uint8 zheader[2] = {0x78, (uint8) (flevel << 6)};
+	zheader[1] += 31 - ((zheader[0] * 256 + zheader[1]) % 31);
 
-		data = (const uint8 *) swappeddata;
-	}
-#endif
+	uLong adler = adler32(0L, Z_NULL, 0);
+	adler = adler32(adler, filtered.data(), (uInt) std::min(filtered.size(), rowspergroup * filteredrowsize));
+
+	size_t zsize = 2 + 4 + groups[0].size();
+	for (int i = 1; i < groupcount; i++)
+	{
+		size_t offset = i * rowspergroup * filteredrowsize;
+		size_t size = std::min(rowspergroup * filteredrowsize, filtered.size() - offset);
+		uLong groupadler = adler32(adler32(0L, Z_NULL, 0), filtered.data() + offset, (uInt) size);
 
-	unsigned status = lodepng_encode(&encimg.data, &encimg.size,
-	                                 data, img.width, img.height, &state);
+		adler = adler32_combine(adler, groupadler, (z_off_t) size);
+		zsize += groups[i].size();
+	}
 
-	if (swappeddata != nullptr)
-		delete[] swappeddata;
+	std::vector<uint8> zdata;
 
-	if (status != 0)
+	try
 	{
-		const char *err = lodepng_error_text(status);
-		throw love::Exception("Could not encode PNG image (%s)", err);
+		zdata.reserve(zsize);
 	}
+	catch (std::exception &)
+	{
+		throw love::Exception("Out of memory.");
+	}
+
+	zdata.insert(zdata.end(), zheader, zheader + 2);
+	for (const auto &group : groups)
+		zdata.insert(zdata.end(), group.begin(), group.end());
+
+	uint8 adlerbytes[4];
+	writeUint32BE(adlerbytes, (uint32) adler);
+	zdata.insert(zdata.end(), adlerbytes, adlerbytes + 4);
+
+	size_t idatcount = (zdata.size() + PNG_MAX_IDAT_SIZE - 1) / PNG_MAX_IDAT_SIZE;
+
+	EncodedImage encimg;
+	encimg.size = 8 + (12 + 13) + idatcount * 12 + zdata.size() + 12;
+
+	// LodePNG-decoded memory is freed with free(), and freeRawPixels is shared
+	// with encoded memory.
+	encimg.data = (unsigned char *) malloc(encimg.size);
+
+	if (encimg.data == nullptr)
+		throw love::Exception("Out of memory.");
+
+	static const uint8 signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+	memcpy(encimg.data, signature, 8);
+
+	uint8 ihdr[13];
+	writeUint32BE(ihdr + 0, (uint32) img.width);
+	writeUint32BE(ihdr + 4, (uint32) img.height);
+	ihdr[8] = (uint8) bitdepth;
+	ihdr[9] = 6; // RGBA
+	ihdr[10] = 0; // Compression method.
+	ihdr[11] = 0; // Filter method.
+	ihdr[12] = 0; // Interlace method.
+
+	uint8 *dst = writeChunk(encimg.data + 8, "IHDR", ihdr, 13);
+
+	for (size_t offset = 0; offset < zdata.size(); offset += PNG_MAX_IDAT_SIZE)
+		dst = writeChunk(dst, "IDAT", zdata.data() + offset, std::min(PNG_MAX_IDAT_SIZE, zdata.size() - offset));
+
+	writeChunk(dst, "IEND", nullptr, 0);
 
 	return encimg;
 }
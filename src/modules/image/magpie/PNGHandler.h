@@ -31,7 +31,8 @@ namespace magpie
 {
 
 /**
- * Interface between ImageData and LodePNG.
+ * Interface between ImageData and LodePNG. Encoding bypasses LodePNG: rows
+ * are filtered and deflated in parallel groups with zlib directly.
  **/
 class PNGHandler : public FormatHandler
 {
@@ -43,7 +44,7 @@ class PNGHandler : public FormatHandler
 	virtual bool canEncode(PixelFormat rawFormat, EncodedFormat encodedFormat);
 
 	virtual DecodedImage decode(Data *data);
-	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format);
+	virtual EncodedImage encode(const DecodedImage &img, EncodedFormat format, const EncodeSettings &settings);
 
 	virtual void freeRawPixels(unsigned char *mem);
 
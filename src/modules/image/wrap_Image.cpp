@@ -152,6 +152,7 @@ static const lua_CFunction types[] =
 {
 	luaopen_imagedata,
 	luaopen_compressedimagedata,
+	luaopen_imageencodetask,
 	0
 };
 
@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_ImageData.h"
+#include "ImageEncodeTask.h"
 
 #include "data/wrap_Data.h"
 #include "filesystem/File.h"
@@ -223,6 +224,123 @@ int w_ImageData_paste(lua_State *L)
 	return 0;
 }
 
+// Reads an optional x, y, width, height rectangle, defaulting to the whole
+// ImageData.
+static void luax_optregion(lua_State *L, int idx, ImageData *t, int &x, int &y, int &w, int &h)
+{
+	x = (int) luaL_optinteger(L, idx + 0, 0);
+	y = (int) luaL_optinteger(L, idx + 1, 0);
+	w = (int) luaL_optinteger(L, idx + 2, t->getWidth() - x);
+	h = (int) luaL_optinteger(L, idx + 3, t->getHeight() - y);
+}
+
+static Colorf luax_checkcolortable(lua_State *L, int idx, float defaultvalue)
+{
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	float c[4];
+	for (int i = 0; i < 4; i++)
+	{
+		lua_rawgeti(L, idx, i + 1);
+		c[i] = (float) luaL_optnumber(L, -1, defaultvalue);
+		lua_pop(L, 1);
+	}
+
+	return Colorf(c[0], c[1], c[2], c[3]);
+}
+
+int w_ImageData_fill(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	Colorf c;
+	c.r = (float) luaL_checknumber(L, 2);
+	c.g = (float) luaL_checknumber(L, 3);
+	c.b = (float) luaL_checknumber(L, 4);
+	c.a = (float) luaL_optnumber(L, 5, 1.0);
+
+	int x, y, w, h;
+	luax_optregion(L, 6, t, x, y, w, h);
+
+	luax_catchexcept(L, [&](){ t->fill(c, x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_transformChannels(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	Colorf scale = luax_checkcolortable(L, 2, 1.0f);
+	Colorf offset = lua_isnoneornil(L, 3) ? Colorf(0.0f, 0.0f, 0.0f, 0.0f) : luax_checkcolortable(L, 3, 0.0f);
+
+	int x, y, w, h;
+	luax_optregion(L, 4, t, x, y, w, h);
+
+	luax_catchexcept(L, [&](){ t->transformChannels(scale, offset, x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_premultiplyAlpha(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	int x, y, w, h;
+	luax_optregion(L, 2, t, x, y, w, h);
+
+	luax_catchexcept(L, [&](){ t->premultiplyAlpha(x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_unpremultiplyAlpha(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	int x, y, w, h;
+	luax_optregion(L, 2, t, x, y, w, h);
+
+	luax_catchexcept(L, [&](){ t->unpremultiplyAlpha(x, y, w, h); });
+	return 0;
+}
+
+int w_ImageData_composite(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+	ImageData *src = luax_checkimagedata(L, 2);
+	int dx = (int) luaL_checkinteger(L, 3);
+	int dy = (int) luaL_checkinteger(L, 4);
+	int sx = (int) luaL_optinteger(L, 5, 0);
+	int sy = (int) luaL_optinteger(L, 6, 0);
+	int sw = (int) luaL_optinteger(L, 7, src->getWidth());
+	int sh = (int) luaL_optinteger(L, 8, src->getHeight());
+
+	ImageData::CompositeMode mode = ImageData::COMPOSITE_ALPHA;
+	if (!lua_isnoneornil(L, 9))
+	{
+		const char *str = luaL_checkstring(L, 9);
+		if (!ImageData::getConstant(str, mode))
+			return luax_enumerror(L, "composite mode", ImageData::getConstants(mode), str);
+	}
+
+	luax_catchexcept(L, [&](){ t->composite(src, dx, dy, sx, sy, sw, sh, mode); });
+	return 0;
+}
+
+int w_ImageData_convert(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	const char *str = luaL_checkstring(L, 2);
+	PixelFormat format = PIXELFORMAT_UNKNOWN;
+	if (!getConstant(str, format))
+		return luax_enumerror(L, "pixel format", str);
+
+	ImageData *c = nullptr;
+	luax_catchexcept(L, [&](){ c = t->convert(format); });
+
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
 int w_ImageData_encode(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -233,16 +351,51 @@ int w_ImageData_encode(lua_State *L)
 		return luax_enumerror(L, "encoded image format", ImageData::getConstants(format), fmt);
 
 	bool hasfilename = false;
+	int optionsidx = 3;
 
 	std::string filename = "Image." + std::string(fmt);
-	if (!lua_isnoneornil(L, 3))
+	if (!lua_isnoneornil(L, 3) && !lua_istable(L, 3))
 	{
 		hasfilename = true;
 		filename = luax_checkstring(L, 3);
+		optionsidx = 4;
+	}
+
+	FormatHandler::EncodeSettings settings;
+	bool async = false;
+
+	if (!lua_isnoneornil(L, optionsidx))
+	{
+		luaL_checktype(L, optionsidx, LUA_TTABLE);
+
+		settings.compression = luax_intflag(L, optionsidx, "compression", settings.compression);
+		if (settings.compression < -1 || settings.compression > 9)
+			return luaL_error(L, "Invalid compression level: %d (must be between 0 and 9)", settings.compression);
+
+		lua_getfield(L, optionsidx, "filter");
+		if (!lua_isnoneornil(L, -1))
+		{
+			const char *str = luaL_checkstring(L, -1);
+			if (!ImageData::getConstant(str, settings.filter))
+				return luax_enumerror(L, "PNG filter", ImageData::getConstants(settings.filter), str);
+		}
+		lua_pop(L, 1);
+
+		async = luax_boolflag(L, optionsidx, "async", false);
+	}
+
+	if (async)
+	{
+		ImageEncodeTask *task = nullptr;
+		luax_catchexcept(L, [&](){ task = t->encodeAsync(format, filename.c_str(), hasfilename, settings); });
+
+		luax_pushtype(L, task);
+		task->release();
+		return 1;
 	}
 
 	love::filesystem::FileData *filedata = nullptr;
-	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename); });
+	luax_catchexcept(L, [&](){ filedata = t->encode(format, filename.c_str(), hasfilename, settings); });
 
 	luax_pushtype(L, filedata);
 	filedata->release();
@@ -320,6 +473,12 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "getPixel", w_ImageData_getPixel },
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
+	{ "fill", w_ImageData_fill },
+	{ "transformChannels", w_ImageData_transformChannels },
+	{ "premultiplyAlpha", w_ImageData_premultiplyAlpha },
+	{ "unpremultiplyAlpha", w_ImageData_unpremultiplyAlpha },
+	{ "composite", w_ImageData_composite },
+	{ "convert", w_ImageData_convert },
 	{ "encode", w_ImageData_encode },
 
 	// Used in the Lua wrapper code.
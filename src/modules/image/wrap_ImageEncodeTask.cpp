@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ImageEncodeTask.h"
+
+namespace love
+{
+namespace image
+{
+
+ImageEncodeTask *luax_checkimageencodetask(lua_State *L, int idx)
+{
+	return luax_checktype<ImageEncodeTask>(L, idx);
+}
+
+static int pushResult(lua_State *L, ImageEncodeTask *t)
+{
+	if (!t->isComplete())
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	love::filesystem::FileData *filedata = t->getFileData();
+	if (filedata != nullptr)
+	{
+		luax_pushtype(L, filedata);
+		return 1;
+	}
+
+	lua_pushnil(L);
+	luax_pushstring(L, t->getError());
+	return 2;
+}
+
+int w_ImageEncodeTask_isComplete(lua_State *L)
+{
+	ImageEncodeTask *t = luax_checkimageencodetask(L, 1);
+	luax_pushboolean(L, t->isComplete());
+	return 1;
+}
+
+int w_ImageEncodeTask_getResult(lua_State *L)
+{
+	ImageEncodeTask *t = luax_checkimageencodetask(L, 1);
+	return pushResult(L, t);
+}
+
+int w_ImageEncodeTask_wait(lua_State *L)
+{
+	ImageEncodeTask *t = luax_checkimageencodetask(L, 1);
+	t->waitComplete();
+	return pushResult(L, t);
+}
+
+static const luaL_Reg w_ImageEncodeTask_functions[] =
+{
+	{ "isComplete", w_ImageEncodeTask_isComplete },
+	{ "getResult", w_ImageEncodeTask_getResult },
+	{ "wait", w_ImageEncodeTask_wait },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_imageencodetask(lua_State *L)
+{
+	return luax_register_type(L, &ImageEncodeTask::type, w_ImageEncodeTask_functions, nullptr);
+}
+
+} // image
+} // love
@@ -25,10 +25,15 @@
 #include "Contact.h"
 #include "Physics.h"
 #include "common/Reference.h"
+#include "thread/parallel.h"
+#include "thread/threads.h"
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
 
+// C++
+#include <algorithm>
+
 namespace love
 {
 namespace physics
@@ -230,6 +235,9 @@ World::World()
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, threadCount(1)
+	, contactBufferEnabled(false)
+	, updateContactEventCount(0)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -248,6 +256,9 @@ World::World(b2Vec2 gravity, bool sleep)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, threadCount(1)
+	, contactBufferEnabled(false)
+	, updateContactEventCount(0)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -271,6 +282,10 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
+	// Events recorded since the last update (e.g. end events from destroying
+	// a Body) are kept, so they can still be read after this one.
+	clearContactEvents(updateContactEventCount);
+
 	world->Step(dt, velocityIterations, positionIterations);
 
 	// Destroy all objects marked during the time step.
@@ -296,18 +311,26 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 	destructFixtures.clear();
 	destructJoints.clear();
 
+	updateContactEventCount = contactEvents.size();
+
 	if (destructWorld)
 		destroy();
 }
 
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (contactBufferEnabled)
+		recordContactEvent(CONTACT_EVENT_BEGIN, contact);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (contactBufferEnabled)
+		recordContactEvent(CONTACT_EVENT_END, contact);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
 	Contact *c = (Contact *)findObject(contact);
@@ -318,12 +341,155 @@ void World::EndContact(b2Contact *contact)
 void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 {
 	B2_NOT_USED(oldManifold); // not sure what to do with this
-	presolve.process(contact);
+	if (contactBufferEnabled)
+		recordContactEvent(CONTACT_EVENT_PRESOLVE, contact);
+	else
+		presolve.process(contact);
 }
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (contactBufferEnabled)
+		recordContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+	else
+		postsolve.process(contact, impulse);
+}
+
+void World::recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	ContactEvent e = {};
+	e.type = (uint32) type;
+	e.fixtureA = getContactEventFixtureIndex(contact->GetFixtureA());
+	e.fixtureB = getContactEventFixtureIndex(contact->GetFixtureB());
+
+	e.pointCount = (uint32) contact->GetManifold()->pointCount;
+
+	// The world manifold is left uninitialized when there are no points.
+	if (e.pointCount > 0)
+	{
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+
+		e.normal[0] = manifold.normal.x;
+		e.normal[1] = manifold.normal.y;
+
+		for (uint32 i = 0; i < e.pointCount; i++)
+		{
+			b2Vec2 position = Physics::scaleUp(manifold.points[i]);
+			e.points[i][0] = position.x;
+			e.points[i][1] = position.y;
+		}
+	}
+
+	if (impulse)
+	{
+		for (int i = 0; i < impulse->count && i < 2; i++)
+		{
+			e.normalImpulses[i] = Physics::scaleUp(impulse->normalImpulses[i]);
+			e.tangentImpulses[i] = Physics::scaleUp(impulse->tangentImpulses[i]);
+		}
+	}
+
+	contactEvents.push_back(e);
+}
+
+uint32 World::getContactEventFixtureIndex(b2Fixture *fixture)
+{
+	Fixture *f = (Fixture *)findObject(fixture);
+	if (f == nullptr)
+		throw love::Exception("A fixture has escaped Memoizer!");
+
+	auto it = contactEventFixtureIndices.find(f);
+	if (it != contactEventFixtureIndices.end())
+		return it->second;
+
+	// Keep the Fixture alive until the buffer is cleared, in case it's
+	// destroyed before Lua reads the events.
+	f->retain();
+	contactEventFixtures.push_back(f);
+
+	uint32 index = (uint32) contactEventFixtures.size();
+	contactEventFixtureIndices[f] = index;
+	return index;
+}
+
+void World::clearContactEvents()
+{
+	for (Fixture *f : contactEventFixtures)
+		f->release();
+
+	contactEvents.clear();
+	contactEventFixtures.clear();
+	contactEventFixtureIndices.clear();
+	updateContactEventCount = 0;
+}
+
+void World::clearContactEvents(size_t count)
+{
+	if (count == 0)
+		return;
+
+	if (count >= contactEvents.size())
+	{
+		clearContactEvents();
+		return;
+	}
+
+	contactEvents.erase(contactEvents.begin(), contactEvents.begin() + count);
+
+	// Renumber the Fixtures which are still referenced, and let go of the
+	// rest.
+	std::vector<Fixture *> oldfixtures;
+	oldfixtures.swap(contactEventFixtures);
+	contactEventFixtureIndices.clear();
+
+	for (ContactEvent &e : contactEvents)
+	{
+		uint32 *indices[] = {&e.fixtureA, &e.fixtureB};
+		for (uint32 *index : indices)
+		{
+			Fixture *f = oldfixtures[*index - 1];
+
+			auto it = contactEventFixtureIndices.find(f);
+			if (it == contactEventFixtureIndices.end())
+			{
+				contactEventFixtures.push_back(f);
+				it = contactEventFixtureIndices.emplace(f, (uint32) contactEventFixtures.size()).first;
+			}
+
+			*index = it->second;
+		}
+	}
+
+	for (Fixture *f : oldfixtures)
+	{
+		if (contactEventFixtureIndices.find(f) == contactEventFixtureIndices.end())
+			f->release();
+	}
+
+	updateContactEventCount = 0;
+}
+
+void World::setContactBufferEnabled(bool enable)
+{
+	contactBufferEnabled = enable;
+	if (!enable)
+		clearContactEvents();
+}
+
+bool World::isContactBufferEnabled() const
+{
+	return contactBufferEnabled;
+}
+
+const std::vector<World::ContactEvent> &World::getContactEvents() const
+{
+	return contactEvents;
+}
+
+const std::vector<Fixture *> &World::getContactEventFixtures() const
+{
+	return contactEventFixtures;
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
@@ -459,6 +625,41 @@ bool World::isLocked() const
 	return world->IsLocked();
 }
 
+void World::setThreadCount(int count)
+{
+	if (count < 1)
+		throw love::Exception("Thread count must be at least 1.");
+
+	if (world->IsLocked())
+		throw love::Exception("Cannot change the thread count while the World is being updated.");
+
+	threadCount = count;
+	world->SetTaskRunner(count > 1 ? this : nullptr);
+}
+
+int World::getThreadCount() const
+{
+	return threadCount;
+}
+
+void World::RunTask(b2Task *task, int32 count)
+{
+	runParallel(count, 1, [&](int begin, int end)
+	{
+		task->Run(begin, end);
+	});
+}
+
+void World::runParallel(int count, int minRangeSize, const std::function<void(int, int)> &body)
+{
+	// parallelFor can use every worker thread, so the ranges are made large
+	// enough that there's at most one per allowed thread.
+	if (threadCount < thread::getParallelThreadCount())
+		minRangeSize = std::max(minRangeSize, (count + threadCount - 1) / threadCount);
+
+	thread::parallelFor(count, minRangeSize, body);
+}
+
 int World::getBodyCount() const
 {
 	return world->GetBodyCount()-1; // ignore the ground body
@@ -496,6 +697,76 @@ int World::getBodies(lua_State *L) const
 	return 1;
 }
 
+void World::getAllBodies(std::vector<Body *> &bodies) const
+{
+	bodies.reserve(bodies.size() + world->GetBodyCount());
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+		Body *body = (Body *)findObject(b);
+		if (!body)
+			throw love::Exception("A body has escaped Memoizer!");
+		bodies.push_back(body);
+	}
+}
+
+void World::getBodyStates(const std::vector<Body *> &bodies, float *states) const
+{
+	for (Body *body : bodies)
+	{
+		const b2Body *b = body->body;
+
+		b2Vec2 position = Physics::scaleUp(b->GetPosition());
+		b2Vec2 velocity = Physics::scaleUp(b->GetLinearVelocity());
+
+		states[0] = position.x;
+		states[1] = position.y;
+		states[2] = b->GetAngle();
+		states[3] = velocity.x;
+		states[4] = velocity.y;
+		states[5] = b->GetAngularVelocity();
+
+		states += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::setBodyStates(const std::vector<Body *> &bodies, const float *states)
+{
+	if (world->IsLocked())
+		throw love::Exception("Cannot set Body states while the World is being updated.");
+
+	for (Body *body : bodies)
+	{
+		b2Body *b = body->body;
+
+		b->SetTransform(Physics::scaleDown(b2Vec2(states[0], states[1])), states[2]);
+		b->SetLinearVelocity(Physics::scaleDown(b2Vec2(states[3], states[4])));
+		b->SetAngularVelocity(states[5]);
+
+		states += BODY_STATE_COMPONENTS;
+	}
+}
+
+void World::setBodyTargets(const std::vector<Body *> &bodies, const float *states, float dt)
+{
+	if (dt <= 0.0f)
+		throw love::Exception("Time step must be greater than 0.");
+
+	for (Body *body : bodies)
+	{
+		b2Body *b = body->body;
+
+		b2Vec2 target = Physics::scaleDown(b2Vec2(states[0], states[1]));
+
+		b->SetLinearVelocity((1.0f / dt) * (target - b->GetPosition()));
+		b->SetAngularVelocity((states[2] - b->GetAngle()) / dt);
+
+		states += BODY_STATE_COMPONENTS;
+	}
+}
+
 int World::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -570,6 +841,195 @@ int World::rayCast(lua_State *L)
 	return 0;
 }
 
+namespace
+{
+
+class ClosestRayCastCallback : public b2RayCastCallback
+{
+public:
+
+	b2Fixture *fixture = nullptr;
+	b2Vec2 point;
+	b2Vec2 normal;
+	float32 fraction = 1.0f;
+
+	float32 ReportFixture(b2Fixture *f, const b2Vec2 &p, const b2Vec2 &n, float32 frac) override
+	{
+		fixture = f;
+		point = p;
+		normal = n;
+		fraction = frac;
+
+		// Clip the ray so only closer fixtures are reported from now on.
+		return frac;
+	}
+};
+
+class AllRayCastCallback : public b2RayCastCallback
+{
+public:
+
+	AllRayCastCallback(World *world, int ray, std::vector<World::RayCastHit> &hits)
+		: world(world)
+		, ray(ray)
+		, hits(hits)
+	{
+	}
+
+	float32 ReportFixture(b2Fixture *f, const b2Vec2 &p, const b2Vec2 &n, float32 frac) override
+	{
+		Fixture *fixture = (Fixture *)world->findObject(f);
+		if (!fixture)
+			throw love::Exception("A fixture has escaped Memoizer!");
+
+		b2Vec2 scaledpoint = Physics::scaleUp(p);
+		hits.push_back({ray, fixture, scaledpoint.x, scaledpoint.y, n.x, n.y, frac});
+		return 1.0f;
+	}
+
+private:
+
+	World *world;
+	int ray;
+	std::vector<World::RayCastHit> &hits;
+};
+
+class BoundingBoxesCallback : public b2QueryCallback
+{
+public:
+
+	BoundingBoxesCallback(World *world, int box, std::vector<World::BoundingBoxHit> &hits)
+		: world(world)
+		, box(box)
+		, hits(hits)
+	{
+	}
+
+	bool ReportFixture(b2Fixture *f) override
+	{
+		Fixture *fixture = (Fixture *)world->findObject(f);
+		if (!fixture)
+			throw love::Exception("A fixture has escaped Memoizer!");
+
+		hits.push_back({box, fixture});
+		return true;
+	}
+
+private:
+
+	World *world;
+	int box;
+	std::vector<World::BoundingBoxHit> &hits;
+};
+
+// Hits found by one range of a batched query, merged in order afterwards.
+template <typename T>
+struct RangeHits
+{
+	int begin;
+	std::vector<T> hits;
+};
+
+template <typename T>
+void mergeRangeHits(std::vector<RangeHits<T>> &ranges, std::vector<T> &hits)
+{
+	std::sort(ranges.begin(), ranges.end(), [](const RangeHits<T> &a, const RangeHits<T> &b)
+	{
+		return a.begin < b.begin;
+	});
+
+	for (const RangeHits<T> &range : ranges)
+		hits.insert(hits.end(), range.hits.begin(), range.hits.end());
+}
+
+} // anonymous namespace
+
+// Batched queries only read the broadphase and fixtures, so ranges of them
+// can run on several threads at once.
+static const int QUERY_MIN_RANGE_SIZE = 64;
+
+void World::rayCastBatch(const float *rays, int count, bool closest, std::vector<RayCastHit> &hits)
+{
+	std::vector<RangeHits<RayCastHit>> ranges;
+	thread::MutexRef mutex;
+
+	runParallel(count, QUERY_MIN_RANGE_SIZE, [&](int begin, int end)
+	{
+		RangeHits<RayCastHit> range;
+		range.begin = begin;
+
+		for (int i = begin; i < end; i++)
+		{
+			const float *r = rays + i * 4;
+			b2Vec2 v1 = Physics::scaleDown(b2Vec2(r[0], r[1]));
+			b2Vec2 v2 = Physics::scaleDown(b2Vec2(r[2], r[3]));
+
+			if (closest)
+			{
+				ClosestRayCastCallback callback;
+				world->RayCast(&callback, v1, v2);
+
+				if (callback.fixture == nullptr)
+					continue;
+
+				Fixture *fixture = (Fixture *)findObject(callback.fixture);
+				if (!fixture)
+					throw love::Exception("A fixture has escaped Memoizer!");
+
+				b2Vec2 point = Physics::scaleUp(callback.point);
+				range.hits.push_back({i, fixture, point.x, point.y, callback.normal.x, callback.normal.y, callback.fraction});
+			}
+			else
+			{
+				size_t first = range.hits.size();
+
+				AllRayCastCallback callback(this, i, range.hits);
+				world->RayCast(&callback, v1, v2);
+
+				// The broadphase reports hits in tree order.
+				std::stable_sort(range.hits.begin() + first, range.hits.end(), [](const RayCastHit &a, const RayCastHit &b)
+				{
+					return a.fraction < b.fraction;
+				});
+			}
+		}
+
+		thread::Lock lock(mutex);
+		ranges.push_back(std::move(range));
+	});
+
+	mergeRangeHits(ranges, hits);
+}
+
+void World::queryBoundingBoxes(const float *boxes, int count, std::vector<BoundingBoxHit> &hits)
+{
+	std::vector<RangeHits<BoundingBoxHit>> ranges;
+	thread::MutexRef mutex;
+
+	runParallel(count, QUERY_MIN_RANGE_SIZE, [&](int begin, int end)
+	{
+		RangeHits<BoundingBoxHit> range;
+		range.begin = begin;
+
+		for (int i = begin; i < end; i++)
+		{
+			const float *b = boxes + i * 4;
+
+			b2AABB box;
+			box.lowerBound = Physics::scaleDown(b2Vec2(b[0], b[1]));
+			box.upperBound = Physics::scaleDown(b2Vec2(b[2], b[3]));
+
+			BoundingBoxesCallback callback(this, i, range.hits);
+			world->QueryAABB(&callback, box);
+		}
+
+		thread::Lock lock(mutex);
+		ranges.push_back(std::move(range));
+	});
+
+	mergeRangeHits(ranges, hits);
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
@@ -608,6 +1068,8 @@ void World::destroy()
 	world->DestroyBody(groundBody);
 	unregisterObject(world);
 
+	clearContactEvents();
+
 	delete world;
 	world = nullptr;
 }
@@ -631,6 +1093,26 @@ love::Object *World::findObject(void *b2object) const
 		return nullptr;
 }
 
+bool World::getConstant(const char *in, ContactEventType &out)
+{
+	return contactEventTypes.find(in, out);
+}
+
+bool World::getConstant(ContactEventType in, const char *&out)
+{
+	return contactEventTypes.find(in, out);
+}
+
+StringMap<World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM>::Entry World::contactEventTypeEntries[] =
+{
+	{"begin", World::CONTACT_EVENT_BEGIN},
+	{"end", World::CONTACT_EVENT_END},
+	{"presolve", World::CONTACT_EVENT_PRESOLVE},
+	{"postsolve", World::CONTACT_EVENT_POSTSOLVE},
+};
+
+StringMap<World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM> World::contactEventTypes(World::contactEventTypeEntries, sizeof(World::contactEventTypeEntries));
+
 } // box2d
 } // physics
 } // love
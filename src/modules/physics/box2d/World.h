@@ -25,8 +25,11 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/StringMap.h"
+#include "common/int.h"
 
 // STD
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
@@ -56,7 +59,7 @@ class Joint;
  * The world also controls global parameters, like
  * gravity.
  **/
-class World : public Object, public b2ContactListener, public b2ContactFilter, public b2DestructionListener
+class World : public Object, public b2ContactListener, public b2ContactFilter, public b2DestructionListener, public b2TaskRunner
 {
 public:
 
@@ -69,6 +72,51 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 
 	static love::Type type;
 
+	struct RayCastHit
+	{
+		int ray;
+		Fixture *fixture;
+		float x, y;
+		float nx, ny;
+		float fraction;
+	};
+
+	struct BoundingBoxHit
+	{
+		int box;
+		Fixture *fixture;
+	};
+
+	// Number of floats per body in the arrays used by get/setBodyStates:
+	// x, y, angle, linear velocity x and y, and angular velocity.
+	static const int BODY_STATE_COMPONENTS = 6;
+
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_PRESOLVE,
+		CONTACT_EVENT_POSTSOLVE,
+		CONTACT_EVENT_MAX_ENUM
+	};
+
+	/**
+	 * A contact event recorded while the contact buffer is enabled. Fixtures
+	 * are stored as 1-based indices into the buffer's fixture list. Points and
+	 * impulses are scaled up, like the values passed to the callbacks.
+	 **/
+	struct ContactEvent
+	{
+		uint32 type;
+		uint32 fixtureA;
+		uint32 fixtureB;
+		uint32 pointCount;
+		float normal[2];
+		float points[2][2];
+		float normalImpulses[2];
+		float tangentImpulses[2];
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -187,6 +235,27 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int getContactFilter(lua_State *L);
 
+	/**
+	 * Enables or disables the contact buffer. While it's enabled, contact
+	 * events are recorded into a native array during update() instead of
+	 * calling the Lua callbacks for each contact.
+	 **/
+	void setContactBufferEnabled(bool enable);
+	bool isContactBufferEnabled() const;
+
+	/**
+	 * Gets the recorded contact events. Events recorded during an update are
+	 * cleared when the next update starts. Events recorded between updates
+	 * (e.g. end events from destroying a Body or Fixture) are kept through
+	 * the next update, and come before its events.
+	 **/
+	const std::vector<ContactEvent> &getContactEvents() const;
+
+	/**
+	 * Gets the Fixtures referenced by the recorded contact events.
+	 **/
+	const std::vector<Fixture *> &getContactEventFixtures() const;
+
 	/**
 	 * Sets the current gravity of the World.
 	 * @param x Gravity in the x-direction.
@@ -227,6 +296,22 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	bool isLocked() const;
 
+	/**
+	 * Sets the maximum number of threads used to solve independent islands
+	 * of bodies during update(). The results are the same as with a single
+	 * thread, but postSolve callbacks are called after all islands are solved.
+	 * @param count The number of threads. 1 disables multithreading.
+	 **/
+	void setThreadCount(int count);
+
+	/**
+	 * Gets the maximum number of threads used during update().
+	 **/
+	int getThreadCount() const;
+
+	// From b2TaskRunner.
+	void RunTask(b2Task *task, int32 count);
+
 	/**
 	 * Get the current body count.
 	 * @return The number of bodies.
@@ -251,6 +336,30 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int getBodies(lua_State *L) const;
 
+	/**
+	 * Gets all the Bodies in the World, in the same order as getBodies.
+	 **/
+	void getAllBodies(std::vector<Body *> &bodies) const;
+
+	/**
+	 * Writes the position, angle and velocities of each Body into the given
+	 * array, BODY_STATE_COMPONENTS floats per Body.
+	 **/
+	void getBodyStates(const std::vector<Body *> &bodies, float *states) const;
+
+	/**
+	 * Sets the position, angle and velocities of each Body from the given
+	 * array, in the layout used by getBodyStates.
+	 **/
+	void setBodyStates(const std::vector<Body *> &bodies, const float *states);
+
+	/**
+	 * Sets the velocities of each Body so it reaches the position and angle
+	 * in the given array after a time step of dt. The velocities in the
+	 * array are ignored. Useful for moving kinematic bodies.
+	 **/
+	void setBodyTargets(const std::vector<Body *> &bodies, const float *states, float dt);
+
 	/**
 	 * Get an array of all the Joints in the World.
 	 * @return An array of Joints.
@@ -279,6 +388,20 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int rayCast(lua_State *L);
 
+	/**
+	 * Casts many rays at once, without calling back into Lua. Each ray is
+	 * given as x1, y1, x2, y2. If closest is true only the closest hit of each
+	 * ray is returned, otherwise every hit is. Hits are ordered by ray, and
+	 * then by fraction along the ray.
+	 **/
+	void rayCastBatch(const float *rays, int count, bool closest, std::vector<RayCastHit> &hits);
+
+	/**
+	 * Finds the Fixtures overlapping many bounding boxes at once. Each box is
+	 * given as top-left x, y and bottom-right x, y. Hits are ordered by box.
+	 **/
+	void queryBoundingBoxes(const float *boxes, int count, std::vector<BoundingBoxHit> &hits);
+
 	/**
 	 * Destroy this world.
 	 **/
@@ -288,8 +411,19 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	void unregisterObject(void *b2object);
 	love::Object *findObject(void *b2object) const;
 
+	static bool getConstant(const char *in, ContactEventType &out);
+	static bool getConstant(ContactEventType in, const char *&out);
+
 private:
 
+	void recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse = nullptr);
+	uint32 getContactEventFixtureIndex(b2Fixture *fixture);
+	void clearContactEvents();
+	void clearContactEvents(size_t count);
+
+	// Runs body over [0, count) using at most threadCount threads.
+	void runParallel(int count, int minRangeSize, const std::function<void(int, int)> &body);
+
 	// Pointer to the Box2D world.
 	b2World *world;
 
@@ -306,8 +440,23 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	ContactCallback begin, end, presolve, postsolve;
 	ContactFilter filter;
 
+	int threadCount;
+
+	// Buffered contact events, and the Fixtures they refer to.
+	bool contactBufferEnabled;
+	std::vector<ContactEvent> contactEvents;
+	std::vector<Fixture *> contactEventFixtures;
+	std::unordered_map<Fixture *, uint32> contactEventFixtureIndices;
+
+	// Number of events recorded by the end of the last update, which are
+	// cleared at the start of the next one.
+	size_t updateContactEventCount;
+
 	std::unordered_map<void *, love::Object *> box2dObjectMap;
 
+	static StringMap<ContactEventType, CONTACT_EVENT_MAX_ENUM>::Entry contactEventTypeEntries[];
+	static StringMap<ContactEventType, CONTACT_EVENT_MAX_ENUM> contactEventTypes;
+
 }; // World
 
 } // box2d
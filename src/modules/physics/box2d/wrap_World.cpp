@@ -19,6 +19,8 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Body.h"
+#include "data/ByteData.h"
 
 namespace love
 {
@@ -130,6 +132,21 @@ int w_World_isLocked(lua_State *L)
 	return 1;
 }
 
+int w_World_setThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->setThreadCount(count); });
+	return 0;
+}
+
+int w_World_getThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, t->getThreadCount());
+	return 1;
+}
+
 int w_World_getBodyCount(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -178,6 +195,239 @@ int w_World_getContacts(lua_State *L)
 	return ret;
 }
 
+int w_World_setContactBufferEnabled(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	t->setContactBufferEnabled(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_World_isContactBufferEnabled(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isContactBufferEnabled());
+	return 1;
+}
+
+static void pushFixtureList(lua_State *L, const std::vector<Fixture *> &fixtures)
+{
+	lua_createtable(L, (int) fixtures.size(), 0);
+	for (int i = 0; i < (int) fixtures.size(); i++)
+	{
+		luax_pushtype(L, fixtures[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	const std::vector<World::ContactEvent> &events = t->getContactEvents();
+
+	// Each event is stored as a fixed-size run of values, so the table stays a
+	// flat array: type, fixtureA, fixtureB, nx, ny, pointcount, x1, y1, x2, y2,
+	// normalimpulse1, tangentimpulse1, normalimpulse2, tangentimpulse2.
+	const int stride = 14;
+
+	lua_createtable(L, (int) events.size() * stride, 0);
+
+	int i = 1;
+	for (const World::ContactEvent &e : events)
+	{
+		const char *typestr = nullptr;
+		World::getConstant((World::ContactEventType) e.type, typestr);
+
+		lua_pushstring(L, typestr);
+		lua_rawseti(L, -2, i++);
+
+		lua_pushinteger(L, e.fixtureA);
+		lua_rawseti(L, -2, i++);
+		lua_pushinteger(L, e.fixtureB);
+		lua_rawseti(L, -2, i++);
+
+		lua_pushnumber(L, e.normal[0]);
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, e.normal[1]);
+		lua_rawseti(L, -2, i++);
+
+		lua_pushinteger(L, e.pointCount);
+		lua_rawseti(L, -2, i++);
+
+		for (int p = 0; p < 2; p++)
+		{
+			lua_pushnumber(L, e.points[p][0]);
+			lua_rawseti(L, -2, i++);
+			lua_pushnumber(L, e.points[p][1]);
+			lua_rawseti(L, -2, i++);
+		}
+
+		for (int p = 0; p < 2; p++)
+		{
+			lua_pushnumber(L, e.normalImpulses[p]);
+			lua_rawseti(L, -2, i++);
+			lua_pushnumber(L, e.tangentImpulses[p]);
+			lua_rawseti(L, -2, i++);
+		}
+	}
+
+	pushFixtureList(L, t->getContactEventFixtures());
+	return 2;
+}
+
+int w_World_getContactEventData(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	const std::vector<World::ContactEvent> &events = t->getContactEvents();
+	size_t size = events.size() * sizeof(World::ContactEvent);
+
+	// Reuse the given Data if it's big enough, so callers can keep a single
+	// buffer around instead of creating a new one every step.
+	Data *data = nullptr;
+	if (!lua_isnoneornil(L, 2))
+	{
+		data = luax_checktype<Data>(L, 2);
+		if (data->getSize() < size)
+			data = nullptr;
+	}
+
+	if (data != nullptr)
+	{
+		if (size > 0)
+			memcpy(data->getData(), events.data(), size);
+		lua_pushvalue(L, 2);
+	}
+	else
+	{
+		// ByteData can't be empty, so an empty buffer still gets one event's
+		// worth of (zeroed) space.
+		love::data::ByteData *d = nullptr;
+		if (size > 0)
+			luax_catchexcept(L, [&]() { d = new love::data::ByteData(events.data(), size); });
+		else
+			luax_catchexcept(L, [&]() { d = new love::data::ByteData(sizeof(World::ContactEvent)); });
+		luax_pushtype(L, d);
+		d->release();
+	}
+
+	lua_pushinteger(L, (lua_Integer) events.size());
+	pushFixtureList(L, t->getContactEventFixtures());
+	return 3;
+}
+
+static void luax_checkbodylist(lua_State *L, int idx, World *world, std::vector<Body *> &bodies)
+{
+	if (lua_isnoneornil(L, idx))
+	{
+		luax_catchexcept(L, [&]() { world->getAllBodies(bodies); });
+		return;
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, idx);
+	bodies.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, idx, i);
+		Body *body = luax_checkbody(L, -1);
+		if (body->getWorld() != world)
+			luaL_error(L, "Body at index %d belongs to a different World.", i);
+		bodies.push_back(body);
+		lua_pop(L, 1);
+	}
+}
+
+int w_World_getBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<Body *> bodies;
+	luax_checkbodylist(L, 2, t, bodies);
+
+	size_t count = bodies.size() * World::BODY_STATE_COMPONENTS;
+
+	if (luax_istype(L, 3, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 3);
+		if (data->getSize() < count * sizeof(float))
+			return luaL_error(L, "Data is too small to hold the states of %d bodies.", (int) bodies.size());
+
+		t->getBodyStates(bodies, (float *) data->getData());
+		lua_pushvalue(L, 3);
+	}
+	else
+	{
+		std::vector<float> states(count);
+		t->getBodyStates(bodies, states.data());
+
+		if (lua_istable(L, 3))
+			lua_pushvalue(L, 3);
+		else if (lua_isnoneornil(L, 3))
+			lua_createtable(L, (int) count, 0);
+		else
+			return luax_typerror(L, 3, "table or Data");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			lua_pushnumber(L, states[i]);
+			lua_rawseti(L, -2, (int) i + 1);
+		}
+	}
+
+	lua_pushinteger(L, (lua_Integer) bodies.size());
+	return 2;
+}
+
+int w_World_setBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<Body *> bodies;
+	luax_checkbodylist(L, 2, t, bodies);
+
+	size_t count = bodies.size() * World::BODY_STATE_COMPONENTS;
+
+	const float *states = nullptr;
+	std::vector<float> tablestates;
+
+	if (luax_istype(L, 3, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, 3);
+		if (data->getSize() < count * sizeof(float))
+			return luaL_error(L, "Data is too small to hold the states of %d bodies.", (int) bodies.size());
+
+		states = (const float *) data->getData();
+	}
+	else
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		if (luax_objlen(L, 3) < count)
+			return luaL_error(L, "Table is too small to hold the states of %d bodies.", (int) bodies.size());
+
+		tablestates.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 3, (int) i + 1);
+			tablestates[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		states = tablestates.data();
+	}
+
+	if (lua_isnoneornil(L, 4))
+		luax_catchexcept(L, [&]() { t->setBodyStates(bodies, states); });
+	else
+	{
+		float dt = (float) luaL_checknumber(L, 4);
+		luax_catchexcept(L, [&]() { t->setBodyTargets(bodies, states, dt); });
+	}
+
+	return 0;
+}
+
 int w_World_queryBoundingBox(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -194,6 +444,126 @@ int w_World_rayCast(lua_State *L)
 	return ret;
 }
 
+// Reads a flat array of floats, with the given number of components per
+// element, from either a table or a Data.
+static const float *luax_checkfloatarray(lua_State *L, int idx, int components, std::vector<float> &storage, int &count)
+{
+	if (luax_istype(L, idx, Data::type))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		count = (int) (data->getSize() / (sizeof(float) * components));
+		return (const float *) data->getData();
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	count = (int) (luax_objlen(L, idx) / components);
+	storage.resize(count * components);
+
+	for (int i = 0; i < count * components; i++)
+	{
+		lua_rawgeti(L, idx, i + 1);
+		storage[i] = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	return storage.data();
+}
+
+// Gets the 1-based index of a Fixture in the list, adding it if needed.
+static int getFixtureListIndex(Fixture *fixture, std::vector<Fixture *> &fixtures, std::unordered_map<Fixture *, int> &indices)
+{
+	auto it = indices.find(fixture);
+	if (it != indices.end())
+		return it->second;
+
+	fixtures.push_back(fixture);
+	int index = (int) fixtures.size();
+	indices[fixture] = index;
+	return index;
+}
+
+int w_World_rayCastBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	int count = 0;
+	const float *rays = luax_checkfloatarray(L, 2, 4, storage, count);
+
+	const char *modestr = luaL_optstring(L, 3, "closest");
+	bool closest = true;
+	if (strcmp(modestr, "closest") == 0)
+		closest = true;
+	else if (strcmp(modestr, "all") == 0)
+		closest = false;
+	else
+		return luaL_error(L, "Invalid ray cast mode: %s (expected 'closest' or 'all')", modestr);
+
+	std::vector<World::RayCastHit> hits;
+	luax_catchexcept(L, [&](){ t->rayCastBatch(rays, count, closest, hits); });
+
+	std::vector<Fixture *> fixtures;
+	std::unordered_map<Fixture *, int> indices;
+
+	// Each hit is stored as: ray, fixture, x, y, nx, ny, fraction.
+	lua_createtable(L, (int) hits.size() * 7, 0);
+
+	int i = 1;
+	for (const World::RayCastHit &hit : hits)
+	{
+		lua_pushinteger(L, hit.ray + 1);
+		lua_rawseti(L, -2, i++);
+		lua_pushinteger(L, getFixtureListIndex(hit.fixture, fixtures, indices));
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, hit.x);
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, hit.y);
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, hit.nx);
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, hit.ny);
+		lua_rawseti(L, -2, i++);
+		lua_pushnumber(L, hit.fraction);
+		lua_rawseti(L, -2, i++);
+	}
+
+	lua_pushinteger(L, (lua_Integer) hits.size());
+	pushFixtureList(L, fixtures);
+	return 3;
+}
+
+int w_World_queryBoundingBoxes(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	int count = 0;
+	const float *boxes = luax_checkfloatarray(L, 2, 4, storage, count);
+
+	std::vector<World::BoundingBoxHit> hits;
+	luax_catchexcept(L, [&](){ t->queryBoundingBoxes(boxes, count, hits); });
+
+	std::vector<Fixture *> fixtures;
+	std::unordered_map<Fixture *, int> indices;
+
+	// Each hit is stored as: box, fixture.
+	lua_createtable(L, (int) hits.size() * 2, 0);
+
+	int i = 1;
+	for (const World::BoundingBoxHit &hit : hits)
+	{
+		lua_pushinteger(L, hit.box + 1);
+		lua_rawseti(L, -2, i++);
+		lua_pushinteger(L, getFixtureListIndex(hit.fixture, fixtures, indices));
+		lua_rawseti(L, -2, i++);
+	}
+
+	lua_pushinteger(L, (lua_Integer) hits.size());
+	pushFixtureList(L, fixtures);
+	return 3;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -233,20 +603,30 @@ static const luaL_Reg w_World_functions[] =
 	{ "getCallbacks", w_World_getCallbacks },
 	{ "setContactFilter", w_World_setContactFilter },
 	{ "getContactFilter", w_World_getContactFilter },
+	{ "setContactBufferEnabled", w_World_setContactBufferEnabled },
+	{ "isContactBufferEnabled", w_World_isContactBufferEnabled },
+	{ "getContactEvents", w_World_getContactEvents },
+	{ "getContactEventData", w_World_getContactEventData },
 	{ "setGravity", w_World_setGravity },
 	{ "getGravity", w_World_getGravity },
 	{ "translateOrigin", w_World_translateOrigin },
 	{ "setSleepingAllowed", w_World_setSleepingAllowed },
 	{ "isSleepingAllowed", w_World_isSleepingAllowed },
 	{ "isLocked", w_World_isLocked },
+	{ "setThreadCount", w_World_setThreadCount },
+	{ "getThreadCount", w_World_getThreadCount },
 	{ "getBodyCount", w_World_getBodyCount },
 	{ "getJointCount", w_World_getJointCount },
 	{ "getContactCount", w_World_getContactCount },
 	{ "getBodies", w_World_getBodies },
 	{ "getJoints", w_World_getJoints },
 	{ "getContacts", w_World_getContacts },
+	{ "getBodyStates", w_World_getBodyStates },
+	{ "setBodyStates", w_World_setBodyStates },
 	{ "queryBoundingBox", w_World_queryBoundingBox },
 	{ "rayCast", w_World_rayCast },
+	{ "rayCastBatch", w_World_rayCastBatch },
+	{ "queryBoundingBoxes", w_World_queryBoundingBoxes },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
@@ -60,6 +60,26 @@ int Decoder::getSampleRate() const
 	return sampleRate;
 }
 
+Data *Decoder::getEncodedData() const
+{
+	return data.get();
+}
+
+int64 Decoder::getSampleCount()
+{
+	return -1;
+}
+
+int64 Decoder::tellSample()
+{
+	return -1;
+}
+
+bool Decoder::seekSample(int64 /*sample*/)
+{
+	return false;
+}
+
 bool Decoder::isFinished()
 {
 	return eof;
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/int.h"
 #include "filesystem/File.h"
 
 #include <string>
@@ -143,6 +144,28 @@ class Decoder : public Object
 	 **/
 	virtual double getDuration() = 0;
 
+	/**
+	 * Gets the encoded data the Decoder reads from.
+	 **/
+	Data *getEncodedData() const;
+
+	/**
+	 * Gets the exact number of sample frames in the stream, or -1 if it isn't
+	 * known. Decoders which know it also support tellSample and seekSample,
+	 * which lets separate parts of the stream be decoded independently.
+	 **/
+	virtual int64 getSampleCount();
+
+	/**
+	 * Gets the index of the next sample frame decode() will return, or -1.
+	 **/
+	virtual int64 tellSample();
+
+	/**
+	 * Seeks to an exact sample frame. Returns false if that isn't supported.
+	 **/
+	virtual bool seekSample(int64 sample);
+
 protected:
 
 	// The encoded data. This should be replaced with buffered file
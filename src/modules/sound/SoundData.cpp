@@ -19,6 +19,7 @@
  **/
 
 #include "SoundData.h"
+#include "thread/parallel.h"
 
 // C
 #include <cstdlib>
@@ -28,6 +29,8 @@
 #include <limits>
 #include <iostream>
 #include <vector>
+#include <atomic>
+#include <algorithm>
 
 namespace love
 {
@@ -46,6 +49,14 @@ SoundData::SoundData(Decoder *decoder)
 	if (decoder->getBitDepth() != 8 && decoder->getBitDepth() != 16)
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
+	channels = decoder->getChannelCount();
+	bitDepth = decoder->getBitDepth();
+	sampleRate = decoder->getSampleRate();
+
+	// Decoders with exact sample seeking can be split up across threads.
+	if (decodeParallel(decoder))
+		return;
+
 	size_t bufferSize = 524288; // 0x80000
 	int decoded = decoder->decode();
 
@@ -82,10 +93,102 @@ SoundData::SoundData(Decoder *decoder)
 	// Shrink buffer if necessary.
 	if (data && bufferSize > size)
 		data = (uint8 *) realloc(data, size);
+}
 
-	channels = decoder->getChannelCount();
-	bitDepth = decoder->getBitDepth();
-	sampleRate = decoder->getSampleRate();
+bool SoundData::decodeParallel(Decoder *decoder)
+{
+	if (thread::getParallelThreadCount() <= 1)
+		return false;
+
+	int64 total = decoder->getSampleCount();
+	int64 start = decoder->tellSample();
+
+	if (total < 0 || start < 0 || start >= total)
+		return false;
+
+	int64 samples = total - start;
+	int64 chunkcount = (samples + PARALLEL_CHUNK_SAMPLES - 1) / PARALLEL_CHUNK_SAMPLES;
+
+	// Not worth opening extra decoders for.
+	if (chunkcount < 2 || chunkcount > std::numeric_limits<int>::max())
+		return false;
+
+	size_t framesize = (size_t) (channels * (bitDepth / 8));
+
+	if ((uint64) samples > std::numeric_limits<size_t>::max() / framesize)
+		throw love::Exception("Not enough memory.");
+
+	size_t bytes = (size_t) samples * framesize;
+	uint8 *dst = (uint8 *) malloc(bytes);
+
+	if (dst == nullptr)
+		throw love::Exception("Not enough memory.");
+
+	std::atomic<bool> failed(false);
+
+	try
+	{
+		// Every range decodes with its own clone of the decoder, and writes the
+		// exact samples of its chunks straight into their place in the buffer.
+		thread::parallelFor((int) chunkcount, 1, [&](int begin, int end)
+		{
+			StrongRef<Decoder> d(decoder->clone(), Acquire::NORETAIN);
+
+			for (int i = begin; i < end && !failed; i++)
+			{
+				int64 first = start + i * PARALLEL_CHUNK_SAMPLES;
+				int64 last = std::min(first + PARALLEL_CHUNK_SAMPLES, total);
+
+				if (d->tellSample() != first && !d->seekSample(first))
+				{
+					failed = true;
+					return;
+				}
+
+				uint8 *out = dst + (size_t) (first - start) * framesize;
+				size_t remaining = (size_t) (last - first) * framesize;
+
+				while (remaining > 0)
+				{
+					int decoded = d->decode();
+
+					if (decoded <= 0 || d->getChannelCount() != channels || d->getBitDepth() != bitDepth)
+					{
+						failed = true;
+						return;
+					}
+
+					// The decoder may run past the end of the chunk.
+					size_t count = std::min((size_t) decoded, remaining);
+					memcpy(out, d->getBuffer(), count);
+
+					out += count;
+					remaining -= count;
+				}
+			}
+		});
+	}
+	catch (love::Exception &)
+	{
+		failed = true;
+	}
+
+	// The original decoder hasn't been touched, so it can still be decoded
+	// serially if any part of the stream couldn't be.
+	if (failed)
+	{
+		free(dst);
+		return false;
+	}
+
+	data = dst;
+	size = bytes;
+
+	// Leave the decoder at the end of the stream, as serial decoding does.
+	if (decoder->seekSample(total))
+		decoder->decode();
+
+	return true;
 }
 
 SoundData::SoundData(int samples, int sampleRate, int bitDepth, int channels)
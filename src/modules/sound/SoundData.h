@@ -64,6 +64,10 @@ class SoundData : public love::Data
 private:
 
 	void load(int samples, int sampleRate, int bitDepth, int channels, void *newData = 0);
+	bool decodeParallel(Decoder *decoder);
+
+	// Number of sample frames decoded by each parallel job.
+	static const int64 PARALLEL_CHUNK_SAMPLES = 1 << 18;
 
 	uint8 *data;
 	size_t size;
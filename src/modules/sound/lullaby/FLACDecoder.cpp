@@ -122,6 +122,29 @@ double FLACDecoder::getDuration()
 	return ((double) flac->totalPCMFrameCount) / ((double) flac->sampleRate);
 }
 
+int64 FLACDecoder::getSampleCount()
+{
+	// A zero count means the stream info didn't specify it.
+	if (flac->totalPCMFrameCount == 0)
+		return -1;
+
+	return (int64) flac->totalPCMFrameCount;
+}
+
+int64 FLACDecoder::tellSample()
+{
+	return (int64) flac->currentPCMFrame;
+}
+
+bool FLACDecoder::seekSample(int64 sample)
+{
+	if (sample < 0 || !drflac_seek_to_pcm_frame(flac, (drflac_uint64) sample))
+		return false;
+
+	eof = false;
+	return true;
+}
+
 } // lullaby
 } // sound
 } // love
@@ -51,6 +51,9 @@ class FLACDecoder : public Decoder
 	int getBitDepth() const;
 	int getSampleRate() const;
 	double getDuration();
+	int64 getSampleCount();
+	int64 tellSample();
+	bool seekSample(int64 sample);
 
 private:
 	drflac *flac;
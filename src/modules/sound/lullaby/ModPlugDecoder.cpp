@@ -23,6 +23,7 @@
 #ifndef LOVE_NO_MODPLUG
 
 #include "common/Exception.h"
+#include "thread/threads.h"
 
 namespace love
 {
@@ -31,6 +32,15 @@ namespace sound
 namespace lullaby
 {
 
+// libmodplug's mixer settings and state are global, so only one ModPlug call
+// can run at a time, whichever decoder and thread it comes from. Streams are
+// decoded on several threads at once, so this matters even within love.audio.
+static love::thread::Mutex *getModPlugMutex()
+{
+	static love::thread::MutexRef mutex;
+	return mutex;
+}
+
 ModPlugDecoder::ModPlugDecoder(Data *data, int bufferSize)
 	: Decoder(data, bufferSize)
 	, plug(0)
@@ -58,6 +68,8 @@ ModPlugDecoder::ModPlugDecoder(Data *data, int bufferSize)
 	settings.mSurroundDelay = 0;
 	settings.mLoopCount = -1;
 
+	love::thread::Lock lock(getModPlugMutex());
+
 	ModPlug_SetSettings(&settings);
 
 	// Load the module.
@@ -72,6 +84,8 @@ ModPlugDecoder::ModPlugDecoder(Data *data, int bufferSize)
 
 ModPlugDecoder::~ModPlugDecoder()
 {
+	love::thread::Lock lock(getModPlugMutex());
+
 	if (plug != 0)
 		ModPlug_Unload(plug);
 }
@@ -103,6 +117,8 @@ love::sound::Decoder *ModPlugDecoder::clone()
 
 int ModPlugDecoder::decode()
 {
+	love::thread::Lock lock(getModPlugMutex());
+
 	int r =  ModPlug_Read(plug, buffer, bufferSize);
 
 	if (r == 0)
@@ -113,12 +129,15 @@ int ModPlugDecoder::decode()
 
 bool ModPlugDecoder::seek(double s)
 {
+	love::thread::Lock lock(getModPlugMutex());
 	ModPlug_Seek(plug, (int)(s*1000.0));
 	return true;
 }
 
 bool ModPlugDecoder::rewind()
 {
+	love::thread::Lock lock(getModPlugMutex());
+
 	// Let's reload.
 	ModPlug_Unload(plug);
 	plug = ModPlug_Load(data->getData(), (int) data->getSize());
@@ -147,6 +166,7 @@ double ModPlugDecoder::getDuration()
 	// Only calculate the duration if we haven't done so already.
 	if (duration == -2.0)
 	{
+		love::thread::Lock lock(getModPlugMutex());
 		int lengthms = ModPlug_GetLength(plug);
 
 		if (lengthms < 0)
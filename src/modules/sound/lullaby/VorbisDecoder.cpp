@@ -279,6 +279,50 @@ double VorbisDecoder::getDuration()
 	return duration;
 }
 
+int64 VorbisDecoder::getSampleCount()
+{
+	// Chained streams can change format between links, so we don't treat
+	// them as a single run of samples.
+	if (ov_streams(&handle) != 1)
+		return -1;
+
+	ogg_int64_t samples = ov_pcm_total(&handle, -1);
+
+	if (samples < 0)
+		return -1;
+
+	return (int64) samples;
+}
+
+int64 VorbisDecoder::tellSample()
+{
+	ogg_int64_t sample = ov_pcm_tell(&handle);
+
+	if (sample < 0)
+		return -1;
+
+	return (int64) sample;
+}
+
+bool VorbisDecoder::seekSample(int64 sample)
+{
+	int result = 0;
+
+	// See the comment in seek() about seeking to PCM 0.
+	if (sample == 0)
+		result = ov_raw_seek(&handle, 0);
+	else if (sample > 0)
+		result = ov_pcm_seek(&handle, (ogg_int64_t) sample);
+	else
+		return false;
+
+	if (result != 0)
+		return false;
+
+	eof = false;
+	return true;
+}
+
 } // lullaby
 } // sound
 } // love
@@ -64,6 +64,9 @@ class VorbisDecoder : public Decoder
 	int getBitDepth() const;
 	int getSampleRate() const;
 	double getDuration();
+	int64 getSampleCount();
+	int64 tellSample();
+	bool seekSample(int64 sample);
 
 private:
 	SOggFile oggFile;				// (see struct)
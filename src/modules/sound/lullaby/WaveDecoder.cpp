@@ -194,6 +194,30 @@ double WaveDecoder::getDuration()
 	return (double) info.length / (double) info.sample_rate;
 }
 
+int64 WaveDecoder::getSampleCount()
+{
+	return (int64) info.length;
+}
+
+int64 WaveDecoder::tellSample()
+{
+	wuff_uint64 offset = 0;
+
+	if (wuff_tell(handle, &offset) < 0)
+		return -1;
+
+	return (int64) offset;
+}
+
+bool WaveDecoder::seekSample(int64 sample)
+{
+	if (sample < 0 || wuff_seek(handle, (wuff_uint64) sample) < 0)
+		return false;
+
+	eof = false;
+	return true;
+}
+
 } // lullaby
 } // sound
 } // love
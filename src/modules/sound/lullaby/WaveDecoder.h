@@ -60,6 +60,9 @@ class WaveDecoder : public Decoder
 	int getBitDepth() const;
 	int getSampleRate() const;
 	double getDuration();
+	int64 getSampleCount();
+	int64 tellSample();
+	bool seekSample(int64 sample);
 
 private:
 
@@ -19,9 +19,14 @@
  **/
 
 #include "Channel.h"
+#include "common/math.h"
+#include "common/Exception.h"
 
 #include <timer/Timer.h>
 
+// C++
+#include <thread>
+
 namespace love
 {
 namespace thread
@@ -30,17 +35,52 @@ namespace thread
 love::Type Channel::type("Channel", &Object::type);
 
 Channel::Channel()
-	: sent(0)
+	: ring(nullptr)
+	, ringMask(0)
+	, ringTail(0)
+	, ringHead(0)
+	, waiters(0)
+	, sent(0)
 	, received(0)
 {
 }
 
+Channel::Channel(int capacity)
+	: Channel()
+{
+	if (capacity <= 0)
+		throw love::Exception("Channel capacity must be greater than 0.");
+
+	// Larger capacities would overflow when rounded up to a power of two.
+	if (capacity > MAX_CAPACITY)
+		throw love::Exception("Channel capacity must not be greater than %d.", MAX_CAPACITY);
+
+	// The ring buffer needs a power-of-two size of at least 2 for the sequence
+	// numbers to distinguish full slots from empty ones.
+	int size = std::max(nextP2(capacity), 2);
+
+	ring = new Slot[size];
+	ringMask = (uint64) size - 1;
+
+	for (int i = 0; i < size; i++)
+		ring[i].sequence.store((uint64) i, std::memory_order_relaxed);
+}
+
 Channel::~Channel()
 {
+	delete[] ring;
 }
 
 uint64 Channel::push(const Variant &var)
 {
+	if (ring != nullptr)
+	{
+		uint64 id = 0;
+		ringWait([&]() { return ringPush(var, &id); }, true, 0.0);
+		ringNotify();
+		return id;
+	}
+
 	Lock l(mutex);
 
 	queue.push(var);
@@ -51,6 +91,12 @@ uint64 Channel::push(const Variant &var)
 
 bool Channel::supply(const Variant &var)
 {
+	if (ring != nullptr)
+	{
+		uint64 id = push(var);
+		return ringWait([&]() { return received >= id; }, true, 0.0);
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -62,6 +108,12 @@ bool Channel::supply(const Variant &var)
 
 bool Channel::supply(const Variant &var, double timeout)
 {
+	if (ring != nullptr)
+	{
+		uint64 id = push(var);
+		return ringWait([&]() { return received >= id; }, false, timeout);
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -82,6 +134,15 @@ bool Channel::supply(const Variant &var, double timeout)
 
 bool Channel::pop(Variant *var)
 {
+	if (ring != nullptr)
+	{
+		if (!ringPop(var))
+			return false;
+
+		ringNotify();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -98,6 +159,13 @@ bool Channel::pop(Variant *var)
 
 bool Channel::demand(Variant *var)
 {
+	if (ring != nullptr)
+	{
+		ringWait([&]() { return ringPop(var); }, true, 0.0);
+		ringNotify();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (!pop(var))
@@ -108,6 +176,15 @@ bool Channel::demand(Variant *var)
 
 bool Channel::demand(Variant *var, double timeout)
 {
+	if (ring != nullptr)
+	{
+		if (!ringWait([&]() { return ringPop(var); }, false, timeout))
+			return false;
+
+		ringNotify();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (timeout >= 0)
@@ -127,6 +204,9 @@ bool Channel::demand(Variant *var, double timeout)
 
 bool Channel::peek(Variant *var)
 {
+	if (ring != nullptr)
+		return ringPeek(var);
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -138,18 +218,39 @@ bool Channel::peek(Variant *var)
 
 int Channel::getCount() const
 {
+	if (ring != nullptr)
+	{
+		uint64 head = ringHead.load(std::memory_order_acquire);
+		uint64 tail = ringTail.load(std::memory_order_acquire);
+		return tail > head ? (int) (tail - head) : 0;
+	}
+
 	Lock l(mutex);
 	return (int) queue.size();
 }
 
 bool Channel::hasRead(uint64 id) const
 {
+	if (ring != nullptr)
+		return received >= id;
+
 	Lock l(mutex);
 	return received >= id;
 }
 
 void Channel::clear()
 {
+	if (ring != nullptr)
+	{
+		// Popping everything also finishes all the supply waits.
+		Variant var;
+		while (ringPop(&var))
+			var = Variant();
+
+		ringNotify();
+		return;
+	}
+
 	Lock l(mutex);
 
 	// We're already empty.
@@ -160,10 +261,20 @@ void Channel::clear()
 		queue.pop();
 
 	// Finish all the supply waits
-	received = sent;
+	received = sent.load();
 	cond->broadcast();
 }
 
+bool Channel::isLockFree() const
+{
+	return ring != nullptr;
+}
+
+int Channel::getCapacity() const
+{
+	return ring != nullptr ? (int) (ringMask + 1) : 0;
+}
+
 void Channel::lockMutex()
 {
 	mutex->lock();
@@ -174,5 +285,146 @@ void Channel::unlockMutex()
 	mutex->unlock();
 }
 
+bool Channel::ringPush(const Variant &var, uint64 *id)
+{
+	uint64 pos = ringTail.load(std::memory_order_relaxed);
+	Slot *slot = nullptr;
+
+	while (true)
+	{
+		slot = &ring[pos & ringMask];
+		uint64 seq = slot->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) (seq - pos);
+
+		if (diff == 0)
+		{
+			if (ringTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // The ring is full.
+		else
+			pos = ringTail.load(std::memory_order_relaxed);
+	}
+
+	slot->value = var;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	*id = pos + 1;
+	return true;
+}
+
+bool Channel::ringPop(Variant *var)
+{
+	uint64 pos = ringHead.load(std::memory_order_relaxed);
+	Slot *slot = nullptr;
+
+	while (true)
+	{
+		slot = &ring[pos & ringMask];
+		uint64 seq = slot->sequence.load(std::memory_order_acquire) & ~SLOT_BUSY_BIT;
+		int64 diff = (int64) (seq - (pos + 1));
+
+		if (diff == 0)
+		{
+			if (ringHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // The ring is empty.
+		else
+			pos = ringHead.load(std::memory_order_relaxed);
+	}
+
+	// peek() may be copying the value right now, wait until it's done.
+	uint64 expected = pos + 1;
+	while (!slot->sequence.compare_exchange_weak(expected, (pos + 1) | SLOT_BUSY_BIT, std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		expected = pos + 1;
+		std::this_thread::yield();
+	}
+
+	*var = slot->value;
+	slot->value = Variant();
+	slot->sequence.store(pos + ringMask + 1, std::memory_order_release);
+
+	received++;
+	return true;
+}
+
+bool Channel::ringPeek(Variant *var)
+{
+	while (true)
+	{
+		uint64 pos = ringHead.load(std::memory_order_acquire);
+		Slot *slot = &ring[pos & ringMask];
+		uint64 seq = slot->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) ((seq & ~SLOT_BUSY_BIT) - (pos + 1));
+
+		if (diff < 0)
+			return false; // The ring is empty.
+		else if (diff > 0)
+			continue; // Another thread popped the value, try the next one.
+
+		uint64 expected = pos + 1;
+		if ((seq & SLOT_BUSY_BIT) == 0 && slot->sequence.compare_exchange_strong(expected, (pos + 1) | SLOT_BUSY_BIT, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			*var = slot->value;
+			slot->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+void Channel::ringNotify()
+{
+	// Pairs with the fence in ringWait, so either the waiting thread sees our
+	// change or we see that it's waiting.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiters.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+template <typename T>
+bool Channel::ringWait(T condition, bool infinite, double timeout)
+{
+	if (condition())
+		return true;
+
+	waiters++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool result = false;
+
+	{
+		Lock l(mutex);
+
+		while (!(result = condition()))
+		{
+			if (infinite)
+				cond->wait(mutex);
+			else if (timeout >= 0)
+			{
+				double start = love::timer::Timer::getTime();
+				cond->wait(mutex, timeout*1000);
+				double stop = love::timer::Timer::getTime();
+
+				timeout -= (stop-start);
+			}
+			else
+				break;
+		}
+	}
+
+	waiters--;
+	return result;
+}
+
 } // thread
 } // love
@@ -23,6 +23,7 @@
 
 // STL
 #include <queue>
+#include <atomic>
 
 // LOVE
 #include "common/Variant.h"
@@ -43,7 +44,17 @@ friend int w_Channel_performAtomic(lua_State *);
 
 	static love::Type type;
 
+	static const int MAX_CAPACITY = 1 << 30;
+
 	Channel();
+
+	/**
+	 * Creates a bounded lock-free Channel which can hold up to 'capacity'
+	 * values (rounded up to the next power of two). Pushing to a full
+	 * lock-free Channel blocks until space is available.
+	 **/
+	Channel(int capacity);
+
 	~Channel();
 
 	uint64 push(const Variant &var);
@@ -57,17 +68,53 @@ friend int w_Channel_performAtomic(lua_State *);
 	bool hasRead(uint64 id) const;
 	void clear();
 
+	bool isLockFree() const;
+	int getCapacity() const;
+
 private:
 
+	// A single entry in the lock-free ring buffer. The sequence number tells
+	// producers and consumers whose turn it is to access the value.
+	struct Slot
+	{
+		std::atomic<uint64> sequence;
+		Variant value;
+	};
+
+	// Set in a slot's sequence while a consumer or peek() is reading its value.
+	static const uint64 SLOT_BUSY_BIT = 1ULL << 63;
+
 	void lockMutex();
 	void unlockMutex();
 
+	bool ringPush(const Variant &var, uint64 *id);
+	bool ringPop(Variant *var);
+	bool ringPeek(Variant *var);
+	void ringNotify();
+
+	template <typename T>
+	bool ringWait(T condition, bool infinite, double timeout);
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
 
-	uint64 sent;
-	uint64 received;
+	// Only used when the Channel is lock-free.
+	Slot *ring;
+	uint64 ringMask;
+
+	// Keep the producer and consumer positions on separate cache lines.
+	char pad0[64];
+	std::atomic<uint64> ringTail;
+	char pad1[64];
+	std::atomic<uint64> ringHead;
+	char pad2[64];
+
+	// Number of threads blocked on the conditional in lock-free mode.
+	std::atomic<int> waiters;
+
+	std::atomic<uint64> sent;
+	std::atomic<uint64> received;
 
 }; // Channel
 
@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Pool.h"
+#include "common/Exception.h"
+
+#ifdef LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love(lua_State * L);
+#endif // LOVE_BUILD_STANDALONE
+
+namespace love
+{
+namespace thread
+{
+
+static const char *CHUNK_CACHE_KEY = "_love_poolchunks";
+
+// The Pool worker running on this thread, if any.
+static thread_local Threadable *currentWorker = nullptr;
+
+// Converts the value at index 2 to a Variant stored at the light userdata at
+// index 1. Used in a protected call, since Variant::fromLua can raise errors.
+static int w_toVariant(lua_State *L)
+{
+	Variant *var = (Variant *) lua_touserdata(L, 1);
+	luax_catchexcept(L, [&]() { *var = Variant::fromLua(L, 2); });
+	return 0;
+}
+
+Pool::Worker::Worker(Pool *pool, int index)
+	: detached(false)
+	, pool(pool)
+	, index(index)
+	, cachedChunks(0)
+{
+	threadName = "Pool worker";
+}
+
+Pool::Worker::~Worker()
+{
+}
+
+void Pool::Worker::threadFunction()
+{
+	currentWorker = this;
+
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+#ifdef LOVE_BUILD_STANDALONE
+	luax_preload(L, luaopen_love, "love");
+	luax_require(L, "love");
+	lua_pop(L, 1);
+#endif // LOVE_BUILD_STANDALONE
+
+	luax_require(L, "love.thread");
+	lua_pop(L, 1);
+
+	// See LuaThread::threadFunction.
+	luax_require(L, "love.filesystem");
+	lua_pop(L, 1);
+
+	lua_newtable(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, CHUNK_CACHE_KEY);
+
+	// The Pool can be destroyed by this thread while it's running a job, if
+	// the job held the last reference to it. It's gone once we're detached.
+	Job job;
+	while (!detached && pool->takeJob(index, job))
+	{
+		run(L, job);
+		job = Job();
+	}
+
+	lua_close(L);
+}
+
+bool Pool::Worker::loadChunk(lua_State *L, const Job &job)
+{
+	const char *code = (const char *) job.code->getData();
+	size_t size = job.code->getSize();
+
+	lua_getfield(L, LUA_REGISTRYINDEX, CHUNK_CACHE_KEY);
+	int cacheidx = lua_gettop(L);
+
+	lua_pushlstring(L, code, size);
+	lua_rawget(L, cacheidx);
+
+	if (lua_isfunction(L, -1))
+	{
+		lua_remove(L, cacheidx);
+		return true;
+	}
+
+	lua_pop(L, 1);
+
+	if (luaL_loadbuffer(L, code, size, job.name.c_str()) != 0)
+	{
+		lua_remove(L, cacheidx);
+		return false;
+	}
+
+	// Start over instead of tracking which chunks are least recently used.
+	if (++cachedChunks > MAX_CACHED_CHUNKS)
+	{
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, CHUNK_CACHE_KEY);
+		lua_replace(L, cacheidx);
+		cachedChunks = 1;
+	}
+
+	lua_pushlstring(L, code, size);
+	lua_pushvalue(L, -2);
+	lua_rawset(L, cacheidx);
+
+	lua_remove(L, cacheidx);
+	return true;
+}
+
+void Pool::Worker::run(lua_State *L, Job &job)
+{
+	lua_pushcfunction(L, luax_traceback);
+	int tracebackidx = lua_gettop(L);
+
+	bool success = false;
+
+	if (loadChunk(L, job))
+	{
+		int pushedargs = (int) job.args.size();
+
+		for (int i = 0; i < pushedargs; i++)
+			job.args[i].toLua(L);
+
+		job.args.clear();
+
+		success = lua_pcall(L, pushedargs, LUA_MULTRET, tracebackidx) == 0;
+	}
+
+	// The results (or the error message) are everything above the traceback
+	// function. Pack them into a table with the success flag first.
+	int nresults = lua_gettop(L) - tracebackidx;
+
+	lua_createtable(L, nresults + 1, 0);
+	luax_pushboolean(L, success);
+	lua_rawseti(L, -2, 1);
+
+	for (int i = 1; i <= nresults; i++)
+	{
+		lua_pushvalue(L, tracebackidx + i);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	Variant result;
+	std::string error;
+
+	lua_pushcfunction(L, w_toVariant);
+	lua_pushlightuserdata(L, &result);
+	lua_pushvalue(L, -3);
+
+	if (lua_pcall(L, 2, 0, 0) != 0)
+		error = luax_tostring(L, -1);
+	else if (result.getType() == Variant::UNKNOWN)
+		error = "boolean, number, string, love type, or table expected";
+
+	if (!error.empty())
+	{
+		lua_createtable(L, 2, 0);
+		luax_pushboolean(L, false);
+		lua_rawseti(L, -2, 1);
+		luax_pushstring(L, "Could not send the job's results: " + error);
+		lua_rawseti(L, -2, 2);
+
+		result = Variant::fromLua(L, -1);
+	}
+
+	job.result->push(result);
+
+	lua_settop(L, tracebackidx - 1);
+}
+
+love::Type Pool::type("Pool", &Object::type);
+
+Pool::Pool(int workerCount)
+	: pending(0)
+	, nextWorker(0)
+	, quit(false)
+{
+	if (workerCount <= 0)
+		throw love::Exception("Pool must have at least one worker.");
+
+	for (int i = 0; i < workerCount; i++)
+		workers.push_back(new Worker(this, i));
+
+	for (Worker *worker : workers)
+	{
+		if (!worker->start())
+		{
+			{
+				Lock l(mutex);
+				quit = true;
+				cond->broadcast();
+			}
+
+			for (Worker *w : workers)
+			{
+				w->wait();
+				w->release();
+			}
+
+			throw love::Exception("Could not start Pool worker thread.");
+		}
+	}
+}
+
+Pool::~Pool()
+{
+	{
+		Lock l(mutex);
+		quit = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		// Waiting for our own thread would never return. The worker stops
+		// taking jobs instead, and its thread keeps it alive until it exits.
+		if (worker == currentWorker)
+			worker->detached = true;
+		else
+			worker->wait();
+
+		worker->release();
+	}
+}
+
+Channel *Pool::submit(love::Data *code, const std::string &name, const std::vector<Variant> &args)
+{
+	Channel *result = new Channel();
+
+	Job job;
+	job.code.set(code);
+	job.name = name;
+	job.args = args;
+	job.result.set(result);
+
+	Worker *worker = workers[nextWorker++ % workers.size()];
+
+	{
+		Lock l(worker->mutex);
+		worker->jobs.push_back(job);
+	}
+
+	{
+		Lock l(mutex);
+		pending++;
+		cond->signal();
+	}
+
+	return result;
+}
+
+int Pool::getWorkerCount() const
+{
+	return (int) workers.size();
+}
+
+int Pool::getPendingCount() const
+{
+	return pending;
+}
+
+bool Pool::takeJob(int index, Job &job)
+{
+	while (true)
+	{
+		if (popJob(index, job))
+			return true;
+
+		Lock l(mutex);
+
+		if (quit)
+			return false;
+
+		// Jobs are only added while holding the mutex, so we can't miss a
+		// signal between this check and the wait.
+		if (pending == 0)
+			cond->wait(mutex);
+	}
+}
+
+bool Pool::popJob(int index, Job &job)
+{
+	int count = (int) workers.size();
+
+	// Take the oldest job from our own queue first, then steal the newest job
+	// from the other workers.
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = workers[(index + i) % count];
+		Lock l(worker->mutex);
+
+		if (worker->jobs.empty())
+			continue;
+
+		if (i == 0)
+		{
+			job = worker->jobs.front();
+			worker->jobs.pop_front();
+		}
+		else
+		{
+			job = worker->jobs.back();
+			worker->jobs.pop_back();
+		}
+
+		pending--;
+		return true;
+	}
+
+	return false;
+}
+
+} // thread
+} // love
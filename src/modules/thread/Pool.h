@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_POOL_H
+#define LOVE_THREAD_POOL_H
+
+// STL
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+// LOVE
+#include "common/Data.h"
+#include "common/Object.h"
+#include "common/Variant.h"
+#include "Channel.h"
+#include "threads.h"
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed set of worker threads, each with a Lua state which stays alive
+ * between jobs. Jobs are queued per worker and idle workers steal from the
+ * queues of busy ones.
+ **/
+class Pool : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	// Compiled chunks are cached per Lua state, up to this many.
+	static const int MAX_CACHED_CHUNKS = 64;
+
+	Pool(int workerCount);
+	virtual ~Pool();
+
+	/**
+	 * Queues Lua code to be run with the given arguments. The returned Channel
+	 * receives a single table once the job is done: {true, results...} if it
+	 * succeeded, or {false, error} if it failed.
+	 **/
+	Channel *submit(love::Data *code, const std::string &name, const std::vector<Variant> &args);
+
+	int getWorkerCount() const;
+	int getPendingCount() const;
+
+private:
+
+	struct Job
+	{
+		StrongRef<love::Data> code;
+		std::string name;
+		std::vector<Variant> args;
+		StrongRef<Channel> result;
+	};
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(Pool *pool, int index);
+		virtual ~Worker();
+
+		void threadFunction() override;
+
+		std::deque<Job> jobs;
+		MutexRef mutex;
+
+		// Set if the Pool was destroyed on this worker's thread.
+		bool detached;
+
+	private:
+
+		bool loadChunk(lua_State *L, const Job &job);
+		void run(lua_State *L, Job &job);
+
+		Pool *pool;
+		int index;
+		int cachedChunks;
+
+	}; // Worker
+
+	bool takeJob(int index, Job &job);
+	bool popJob(int index, Job &job);
+
+	std::vector<Worker *> workers;
+
+	// Guards quit and sleeping on the conditional while there's no work.
+	MutexRef mutex;
+	ConditionalRef cond;
+
+	std::atomic<int> pending;
+	std::atomic<unsigned int> nextWorker;
+	bool quit;
+
+}; // Pool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_POOL_H
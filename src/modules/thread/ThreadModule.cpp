@@ -35,6 +35,16 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+Channel *ThreadModule::newChannel(int capacity)
+{
+	return new Channel(capacity);
+}
+
+Pool *ThreadModule::newPool(int workerCount)
+{
+	return new Pool(workerCount);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	Lock lock(namedChannelMutex);
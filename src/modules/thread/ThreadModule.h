@@ -33,6 +33,7 @@
 #include "Thread.h"
 #include "Channel.h"
 #include "LuaThread.h"
+#include "Pool.h"
 #include "threads.h"
 
 namespace love
@@ -46,6 +47,8 @@ class ThreadModule : public love::Module
 	virtual ~ThreadModule() {}
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual Channel *newChannel(int capacity);
+	virtual Pool *newPool(int workerCount);
 	virtual Channel *getChannel(const std::string &name);
 
 	// Implements Module.
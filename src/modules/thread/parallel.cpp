@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "parallel.h"
+#include "threads.h"
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+namespace
+{
+
+struct Batch
+{
+	const std::function<void(int, int)> *body;
+	int count;
+	int rangeSize;
+	int ranges;
+
+	std::atomic<int> nextRange;
+	std::atomic<int> remainingRanges;
+
+	// The first exception thrown by a range. Rethrown on the calling thread
+	// once every range is done.
+	std::atomic<bool> failed;
+	std::exception_ptr error;
+
+	// Number of worker threads currently looking at this batch. Only accessed
+	// while holding the WorkerThreads mutex.
+	int users;
+};
+
+// Set while a thread is running a range, so nested parallelFor calls don't
+// wait on work that can't start until they return.
+thread_local bool insideRange = false;
+
+// Runs ranges of the batch until there are none left. Returns true if this
+// call finished the batch's last range.
+bool runRanges(Batch *batch)
+{
+	bool finished = false;
+	insideRange = true;
+
+	while (true)
+	{
+		int range = batch->nextRange++;
+		if (range >= batch->ranges)
+			break;
+
+		int begin = range * batch->rangeSize;
+		int end = std::min(begin + batch->rangeSize, batch->count);
+
+		try
+		{
+			(*batch->body)(begin, end);
+		}
+		catch (...)
+		{
+			bool expected = false;
+			if (batch->failed.compare_exchange_strong(expected, true))
+				batch->error = std::current_exception();
+		}
+
+		if (--batch->remainingRanges == 0)
+			finished = true;
+	}
+
+	insideRange = false;
+	return finished;
+}
+
+class WorkerThreads
+{
+public:
+
+	WorkerThreads();
+	~WorkerThreads();
+
+	void run(Batch *batch);
+	int getThreadCount() const { return (int) workers.size() + 1; }
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(WorkerThreads *owner)
+			: owner(owner)
+		{
+			threadName = "Parallel worker";
+		}
+
+		void threadFunction() override
+		{
+			owner->workerLoop();
+		}
+
+	private:
+
+		WorkerThreads *owner;
+	};
+
+	void workerLoop();
+
+	std::vector<Worker *> workers;
+	std::deque<Batch *> batches;
+
+	MutexRef mutex;
+	ConditionalRef workCond;
+	ConditionalRef doneCond;
+
+	bool quit;
+};
+
+WorkerThreads::WorkerThreads()
+	: quit(false)
+{
+	int count = (int) std::thread::hardware_concurrency() - 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		if (worker->start())
+			workers.push_back(worker);
+		else
+			worker->release();
+	}
+}
+
+WorkerThreads::~WorkerThreads()
+{
+	{
+		Lock l(mutex);
+		quit = true;
+		workCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+}
+
+void WorkerThreads::run(Batch *batch)
+{
+	{
+		Lock l(mutex);
+		batches.push_back(batch);
+		workCond->broadcast();
+	}
+
+	runRanges(batch);
+
+	Lock l(mutex);
+
+	// Wait for the other threads to finish their ranges and let go of the
+	// batch, since it lives on the caller's stack.
+	while (batch->remainingRanges > 0 || batch->users > 0)
+		doneCond->wait(mutex);
+
+	auto it = std::find(batches.begin(), batches.end(), batch);
+	if (it != batches.end())
+		batches.erase(it);
+
+	if (batch->failed)
+		std::rethrow_exception(batch->error);
+}
+
+void WorkerThreads::workerLoop()
+{
+	Lock l(mutex);
+
+	while (!quit)
+	{
+		// Drop batches which have no ranges left to hand out.
+		while (!batches.empty() && batches.front()->nextRange >= batches.front()->ranges)
+			batches.pop_front();
+
+		if (batches.empty())
+		{
+			workCond->wait(mutex);
+			continue;
+		}
+
+		Batch *batch = batches.front();
+		batch->users++;
+
+		mutex->unlock();
+		runRanges(batch);
+		mutex->lock();
+
+		batch->users--;
+		doneCond->broadcast();
+	}
+}
+
+WorkerThreads &getWorkerThreads()
+{
+	static WorkerThreads workerThreads;
+	return workerThreads;
+}
+
+} // anonymous namespace
+
+void parallelFor(int count, int minRangeSize, const std::function<void(int, int)> &body)
+{
+	if (count <= 0)
+		return;
+
+	minRangeSize = std::max(minRangeSize, 1);
+
+	if (insideRange || count <= minRangeSize)
+	{
+		body(0, count);
+		return;
+	}
+
+	WorkerThreads &threads = getWorkerThreads();
+	int threadcount = threads.getThreadCount();
+
+	if (threadcount <= 1)
+	{
+		body(0, count);
+		return;
+	}
+
+	// A few ranges per thread, so uneven work still balances out.
+	int rangeSize = std::max(minRangeSize, count / (threadcount * 4));
+
+	Batch batch;
+	batch.body = &body;
+	batch.count = count;
+	batch.rangeSize = rangeSize;
+	batch.ranges = (count + rangeSize - 1) / rangeSize;
+	batch.nextRange = 0;
+	batch.remainingRanges = batch.ranges;
+	batch.failed = false;
+	batch.users = 0;
+
+	threads.run(&batch);
+}
+
+int getParallelThreadCount()
+{
+	return getWorkerThreads().getThreadCount();
+}
+
+} // thread
+} // love
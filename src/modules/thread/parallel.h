@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_PARALLEL_H
+#define LOVE_THREAD_PARALLEL_H
+
+// C++
+#include <functional>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Splits [0, count) into contiguous ranges of at least minRangeSize items and
+ * calls body(begin, end) for each of them, spread across a shared set of
+ * native worker threads and the calling thread. Returns once every range is
+ * done. Calls made from inside a body run serially on the calling thread. If
+ * a body throws, the remaining ranges still run and the first exception is
+ * rethrown to the caller.
+ **/
+void parallelFor(int count, int minRangeSize, const std::function<void(int, int)> &body);
+
+/**
+ * Gets the number of threads (including the calling thread) parallelFor will
+ * split work across.
+ **/
+int getParallelThreadCount();
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_PARALLEL_H
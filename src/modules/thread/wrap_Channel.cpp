@@ -90,6 +90,35 @@ int w_Channel_demand(lua_State *L)
 	return 1;
 }
 
+int w_Channel_popView(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	Variant var;
+	if (c->pop(&var))
+		var.toLuaView(L);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_Channel_demandView(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	Variant var;
+	bool result = false;
+
+	if (lua_isnumber(L, 2))
+		result = c->demand(&var, lua_tonumber(L, 2));
+	else
+		result = c->demand(&var);
+
+	if (result)
+		var.toLuaView(L);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
 int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -128,6 +157,11 @@ int w_Channel_performAtomic(lua_State *L)
 	Channel *c = luax_checkchannel(L, 1);
 	luaL_checktype(L, 2, LUA_TFUNCTION);
 
+	// Lock-free Channels don't take the mutex for regular operations, so it
+	// can't make a sequence of them atomic.
+	if (c->isLockFree())
+		return luaL_error(L, "performAtomic cannot be used with lock-free Channels.");
+
 	// Pass this channel as an argument to the function.
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
@@ -156,6 +190,8 @@ static const luaL_Reg w_Channel_functions[] =
 	{ "supply", w_Channel_supply },
 	{ "pop", w_Channel_pop },
 	{ "demand", w_Channel_demand },
+	{ "popView", w_Channel_popView },
+	{ "demandView", w_Channel_demandView },
 	{ "peek", w_Channel_peek },
 	{ "getCount", w_Channel_getCount },
 	{ "hasRead", w_Channel_hasRead },
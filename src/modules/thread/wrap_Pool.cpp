@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2006-2020 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Pool.h"
+#include "wrap_ThreadModule.h"
+#include "filesystem/FileData.h"
+
+// C
+#include <cstring>
+
+namespace love
+{
+namespace thread
+{
+
+Pool *luax_checkpool(lua_State *L, int idx)
+{
+	return luax_checktype<Pool>(L, idx);
+}
+
+static int writeChunk(lua_State *, const void *p, size_t size, void *ud)
+{
+	std::vector<char> *bytecode = (std::vector<char> *) ud;
+	bytecode->insert(bytecode->end(), (const char *) p, (const char *) p + size);
+	return 0;
+}
+
+int w_Pool_submit(lua_State *L)
+{
+	Pool *pool = luax_checkpool(L, 1);
+
+	std::string name = "Pool job";
+	love::Data *code = nullptr;
+	StrongRef<love::Data> bytecodeData;
+
+	if (lua_isfunction(L, 2))
+	{
+		// Functions are sent as bytecode. Their upvalues don't come along.
+		std::vector<char> bytecode;
+		lua_pushvalue(L, 2);
+#if LUA_VERSION_NUM >= 503
+		int err = lua_dump(L, writeChunk, &bytecode, 0);
+#else
+		int err = lua_dump(L, writeChunk, &bytecode);
+#endif
+		lua_pop(L, 1);
+
+		if (err != 0 || bytecode.empty())
+			return luaL_argerror(L, 2, "function could not be dumped");
+
+		luax_catchexcept(L, [&]() {
+			love::filesystem::FileData *fdata = new love::filesystem::FileData(bytecode.size(), name);
+			memcpy(fdata->getData(), bytecode.data(), bytecode.size());
+			bytecodeData.set(fdata, Acquire::NORETAIN);
+		});
+
+		code = bytecodeData;
+	}
+	else
+		code = luax_checkcode(L, 2, name);
+
+	std::vector<Variant> args;
+	int nargs = lua_gettop(L) - 2;
+
+	for (int i = 0; i < nargs; ++i)
+	{
+		luax_catchexcept(L, [&]() {
+			args.push_back(Variant::fromLua(L, i+3));
+		});
+
+		if (args.back().getType() == Variant::UNKNOWN)
+		{
+			args.clear();
+			return luaL_argerror(L, i+3, "boolean, number, string, love type, or table expected");
+		}
+	}
+
+	Channel *result = nullptr;
+	luax_catchexcept(L, [&]() { result = pool->submit(code, name, args); });
+
+	luax_pushtype(L, result);
+	result->release();
+	return 1;
+}
+
+int w_Pool_getWorkerCount(lua_State *L)
+{
+	Pool *pool = luax_checkpool(L, 1);
+	lua_pushinteger(L, pool->getWorkerCount());
+	return 1;
+}
+
+int w_Pool_getPendingCount(lua_State *L)
+{
+	Pool *pool = luax_checkpool(L, 1);
+	lua_pushinteger(L, pool->getPendingCount());
+	return 1;
+}
+
+static const luaL_Reg w_Pool_functions[] =
+{
+	{ "submit", w_Pool_submit },
+	{ "getWorkerCount", w_Pool_getWorkerCount },
+	{ "getPendingCount", w_Pool_getPendingCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_pool(lua_State *L)
+{
+	return luax_register_type(L, &Pool::type, w_Pool_functions, nullptr);
+}
+
+} // thread
+} // love
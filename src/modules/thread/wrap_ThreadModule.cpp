@@ -22,6 +22,7 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_Pool.h"
 #include "ThreadModule.h"
 
 #include "filesystem/File.h"
@@ -30,6 +31,9 @@
 // C
 #include <cstring>
 
+// C++
+#include <thread>
+
 namespace love
 {
 namespace thread
@@ -37,43 +41,47 @@ namespace thread
 
 #define instance() (Module::getInstance<ThreadModule>(Module::M_THREAD))
 
-int w_newThread(lua_State *L)
+love::Data *luax_checkcode(lua_State *L, int idx, std::string &name)
 {
-	std::string name = "Thread code";
-	love::Data *data = nullptr;
+	if (idx < 0)
+		idx += lua_gettop(L) + 1;
 
-	if (lua_isstring(L, 1))
+	if (lua_isstring(L, idx))
 	{
 		size_t slen = 0;
-		const char *str = lua_tolstring(L, 1, &slen);
+		const char *str = lua_tolstring(L, idx, &slen);
 
 		// Treat the string as Lua code if it's long or has a newline.
 		if (slen >= 1024 || memchr(str, '\n', slen))
 		{
 			// Construct a FileData from the string.
-			lua_pushvalue(L, 1);
+			lua_pushvalue(L, idx);
 			lua_pushstring(L, "string");
 			int idxs[] = {lua_gettop(L) - 1, lua_gettop(L)};
 			luax_convobj(L, idxs, 2, "filesystem", "newFileData");
 			lua_pop(L, 1);
-			lua_replace(L, 1);
+			lua_replace(L, idx);
 		}
 		else
-			luax_convobj(L, 1, "filesystem", "newFileData");
+			luax_convobj(L, idx, "filesystem", "newFileData");
 	}
-	else if (luax_istype(L, 1, love::filesystem::File::type))
-		luax_convobj(L, 1, "filesystem", "newFileData");
+	else if (luax_istype(L, idx, love::filesystem::File::type))
+		luax_convobj(L, idx, "filesystem", "newFileData");
 
-	if (luax_istype(L, 1, love::filesystem::FileData::type))
+	if (luax_istype(L, idx, love::filesystem::FileData::type))
 	{
-		love::filesystem::FileData *fdata = luax_checktype<love::filesystem::FileData>(L, 1);
+		love::filesystem::FileData *fdata = luax_checktype<love::filesystem::FileData>(L, idx);
 		name = std::string("@") + fdata->getFilename();
-		data = fdata;
+		return fdata;
 	}
 	else
-	{
-		data = luax_checktype<love::Data>(L, 1);
-	}
+		return luax_checktype<love::Data>(L, idx);
+}
+
+int w_newThread(lua_State *L)
+{
+	std::string name = "Thread code";
+	love::Data *data = luax_checkcode(L, 1, name);
 
 	LuaThread *t = instance()->newThread(name, data);
 	luax_pushtype(L, t);
@@ -83,12 +91,33 @@ int w_newThread(lua_State *L)
 
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	Channel *c = nullptr;
+
+	if (lua_istable(L, 1) && luax_boolflag(L, 1, "lockfree", false))
+	{
+		int capacity = luax_intflag(L, 1, "capacity", 1024);
+		luax_catchexcept(L, [&](){ c = instance()->newChannel(capacity); });
+	}
+	else if (lua_istable(L, 1) && luax_intflag(L, 1, "capacity", 0) != 0)
+		return luaL_error(L, "Only lock-free Channels can have a capacity.");
+	else
+		c = instance()->newChannel();
+
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
 }
 
+int w_newPool(lua_State *L)
+{
+	int workers = (int) luaL_optinteger(L, 1, (lua_Integer) std::thread::hardware_concurrency());
+	Pool *pool = nullptr;
+	luax_catchexcept(L, [&](){ pool = instance()->newPool(std::max(workers, 1)); });
+	luax_pushtype(L, pool);
+	pool->release();
+	return 1;
+}
+
 int w_getChannel(lua_State *L)
 {
 	std::string name = luax_checkstring(L, 1);
@@ -102,6 +131,7 @@ static const luaL_Reg module_functions[] =
 {
 	{ "newThread", w_newThread },
 	{ "newChannel", w_newChannel },
+	{ "newPool", w_newPool },
 	{ "getChannel", w_getChannel },
 	{ 0, 0 }
 };
@@ -109,6 +139,7 @@ static const luaL_Reg module_functions[] =
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_pool,
 	0
 };
 
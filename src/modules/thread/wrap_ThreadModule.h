@@ -24,12 +24,22 @@
 // LOVE
 #include "common/config.h"
 #include "common/runtime.h"
+#include "common/Data.h"
+
+// C++
+#include <string>
 
 namespace love
 {
 namespace thread
 {
 
+/**
+ * Gets Lua code from a Data, File, filename or string of code at the given
+ * index, converting the value on the stack to a FileData where needed.
+ **/
+love::Data *luax_checkcode(lua_State *L, int idx, std::string &name);
+
 extern "C" LOVE_EXPORT int luaopen_love_thread(lua_State * L);
 
 } // thread
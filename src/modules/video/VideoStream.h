@@ -50,6 +50,12 @@ class VideoStream : public Stream
 	virtual double tell() const;
 	virtual bool isPlaying() const;
 
+	// Decoded frame queue api
+	virtual void setFrameQueueSize(int size) = 0;
+	virtual int getFrameQueueSize() const = 0;
+	virtual int getQueuedFrameCount() const = 0;
+	virtual int getDroppedFrameCount() const = 0;
+
 	class FrameSync;
 	class DeltaSync;
 
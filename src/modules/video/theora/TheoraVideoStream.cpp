@@ -37,7 +37,12 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
+	, frontBuffer(nullptr)
+	, frameCount(0)
+	, frameQueueSize(0)
+	, droppedFrames(0)
+	, frontTime(-1)
+	, presentPosition(0)
 	, lastFrame(0)
 	, nextFrame(0)
 {
@@ -46,21 +51,19 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 
 	th_info_init(&videoInfo);
 
-	frontBuffer = new Frame();
-	backBuffer = new Frame();
-
 	try
 	{
 		parseHeader();
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
-		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
 	}
 
+	frontBuffer = newFrame();
+	setFrameQueueSize(DEFAULT_FRAME_QUEUE_SIZE);
+
 	frameSync.set(new DeltaSync(), Acquire::NORETAIN);
 }
 
@@ -71,8 +74,13 @@ TheoraVideoStream::~TheoraVideoStream()
 
 	th_info_clear(&videoInfo);
 
+	for (const QueuedFrame &queued : frameQueue)
+		delete queued.frame;
+
+	for (Frame *frame : freeFrames)
+		delete frame;
+
 	delete frontBuffer;
-	delete backBuffer;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -114,7 +122,55 @@ size_t TheoraVideoStream::getSize() const
 
 bool TheoraVideoStream::isPlaying() const
 {
-	return frameSync->isPlaying() && !demuxer.isEos();
+	if (!frameSync->isPlaying())
+		return false;
+
+	// Frames decoded ahead of time still have to be shown after the end of the
+	// file has been reached.
+	love::thread::Lock l(bufferMutex);
+	return !demuxer.isEos() || !frameQueue.empty();
+}
+
+void TheoraVideoStream::setFrameQueueSize(int size)
+{
+	if (size < 1)
+		throw love::Exception("Frame queue size must be at least 1.");
+
+	love::thread::Lock l(bufferMutex);
+
+	frameQueueSize = size;
+
+	while (frameCount < frameQueueSize)
+	{
+		freeFrames.push_back(newFrame());
+		frameCount++;
+	}
+
+	// Frames in use when the queue shrinks are freed once they're released.
+	while (frameCount > frameQueueSize && !freeFrames.empty())
+	{
+		delete freeFrames.back();
+		freeFrames.pop_back();
+		frameCount--;
+	}
+}
+
+int TheoraVideoStream::getFrameQueueSize() const
+{
+	love::thread::Lock l(bufferMutex);
+	return frameQueueSize;
+}
+
+int TheoraVideoStream::getQueuedFrameCount() const
+{
+	love::thread::Lock l(bufferMutex);
+	return (int) frameQueue.size();
+}
+
+int TheoraVideoStream::getDroppedFrameCount() const
+{
+	love::thread::Lock l(bufferMutex);
+	return droppedFrames;
 }
 
 template<typename T>
@@ -162,31 +218,70 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
-
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
-	{
-		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
-		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
+	headerParsed = true;
+	th_decode_packetin(decoder, &packet, nullptr);
+}
+
+VideoStream::Frame *TheoraVideoStream::newFrame() const
+{
+	Frame *frame = new Frame();
+
+	frame->cw = frame->yw = videoInfo.pic_width;
+	frame->ch = frame->yh = videoInfo.pic_height;
+
+	scaleFormat(videoInfo.pixel_fmt, frame->cw, frame->ch);
+
+	frame->yplane = new unsigned char[frame->yw * frame->yh];
+	frame->cbplane = new unsigned char[frame->cw * frame->ch];
+	frame->crplane = new unsigned char[frame->cw * frame->ch];
+
+	memset(frame->yplane, 16, frame->yw * frame->yh);
+	memset(frame->cbplane, 128, frame->cw * frame->ch);
+	memset(frame->crplane, 128, frame->cw * frame->ch);
+
+	return frame;
+}
+
+static void copyPlane(unsigned char *dst, int w, int h, const th_img_plane &src, unsigned int xoffset, unsigned int yoffset)
+{
+	// Theora's planes are padded and may be stored bottom-up (negative
+	// stride), so rows are copied one at a time.
+	const unsigned char *srcdata = src.data + src.stride * (ptrdiff_t) yoffset + xoffset;
 
-		scaleFormat(videoInfo.pixel_fmt, buffers[i]->cw, buffers[i]->ch);
+	for (int y = 0; y < h; ++y)
+		memcpy(dst + (size_t) w * y, srcdata + src.stride * (ptrdiff_t) y, w);
+}
 
-		buffers[i]->yplane = new unsigned char[buffers[i]->yw * buffers[i]->yh];
-		buffers[i]->cbplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-		buffers[i]->crplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
+void TheoraVideoStream::copyPlanes(const th_ycbcr_buffer &bufferinfo, Frame *frame) const
+{
+	copyPlane(frame->yplane, frame->yw, frame->yh, bufferinfo[0], yPlaneXOffset, yPlaneYOffset);
+	copyPlane(frame->cbplane, frame->cw, frame->ch, bufferinfo[1], cPlaneXOffset, cPlaneYOffset);
+	copyPlane(frame->crplane, frame->cw, frame->ch, bufferinfo[2], cPlaneXOffset, cPlaneYOffset);
+}
 
-		memset(buffers[i]->yplane, 16, buffers[i]->yw * buffers[i]->yh);
-		memset(buffers[i]->cbplane, 128, buffers[i]->cw * buffers[i]->ch);
-		memset(buffers[i]->crplane, 128, buffers[i]->cw * buffers[i]->ch);
+void TheoraVideoStream::releaseFrame(Frame *frame)
+{
+	// The queue may have shrunk since this frame was allocated.
+	if (frameCount > frameQueueSize)
+	{
+		delete frame;
+		frameCount--;
 	}
+	else
+		freeFrames.push_back(frame);
+}
 
-	headerParsed = true;
-	th_decode_packetin(decoder, &packet, nullptr);
+void TheoraVideoStream::clearFrameQueue()
+{
+	for (const QueuedFrame &queued : frameQueue)
+		releaseFrame(queued.frame);
+
+	frameQueue.clear();
 }
 
 void TheoraVideoStream::seekDecoder(double target)
@@ -209,77 +304,86 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 	frameSync->update(dt);
 	double position = frameSync->getPosition();
 
-	// Seeking backwards
-	if (position < lastFrame)
-		seekDecoder(position);
+	bool seekBackwards = false;
+
+	{
+		love::thread::Lock l(bufferMutex);
+		presentPosition = position;
 
-	th_ycbcr_buffer bufferinfo;
-	bool hasFrame = false;
+		// Seeking backwards, the queued frames won't be shown anymore
+		if (position < frontTime)
+		{
+			clearFrameQueue();
+			frontTime = -1;
+			seekBackwards = true;
+		}
+	}
 
-	// Until we are at the end of the stream, or we are displaying the right frame
+	if (seekBackwards)
+		seekDecoder(position);
+
+	// Decode ahead until the queue is full, or we are at the end of the stream
 	unsigned int framesBehind = 0;
 	bool failedSeek = false;
-	while (!demuxer.isEos() && position >= nextFrame)
+	while (!demuxer.isEos())
 	{
+		Frame *frame = nullptr;
+
+		{
+			love::thread::Lock l(bufferMutex);
+			if ((int) frameQueue.size() >= frameQueueSize || freeFrames.empty())
+				break;
+
+			frame = freeFrames.back();
+			freeFrames.pop_back();
+		}
+
 		// If we can't catch up, seek
-		if (framesBehind++ > 5 && !failedSeek)
+		if (position >= nextFrame && framesBehind++ > 5 && !failedSeek)
 		{
 			seekDecoder(position);
 			framesBehind = 0;
 			failedSeek = true;
 		}
 
+		double frameTime = nextFrame;
+
+		th_ycbcr_buffer bufferinfo;
 		th_decode_ycbcr_out(decoder, bufferinfo);
-		hasFrame = true;
 
+		bool eos = false;
 		ogg_int64_t granulePosition;
 		do
 		{
 			if (demuxer.readPacket(packet))
-				return;
+			{
+				eos = true;
+				break;
+			}
 		} while (th_decode_packetin(decoder, &packet, &granulePosition) != 0);
-		lastFrame = nextFrame;
-		nextFrame = th_granule_time(decoder, granulePosition);
-	}
 
-	// Only swap once, even if we read many frames to get here
-	if (hasFrame)
-	{
-		// Don't swap whilst we're writing to the backbuffer
+		if (!eos)
 		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = false;
+			lastFrame = nextFrame;
+			nextFrame = th_granule_time(decoder, granulePosition);
 		}
 
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
+		// A frame whose successor is already due would be skipped right away,
+		// so there's no need to copy it.
+		bool late = !eos && position >= nextFrame;
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+		if (!late)
+			copyPlanes(bufferinfo, frame);
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+		love::thread::Lock l(bufferMutex);
 
-		// Re-enable swapping
+		if (late)
 		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = true;
+			releaseFrame(frame);
+			droppedFrames++;
 		}
+		else
+			frameQueue.push_back({frame, frameTime});
 	}
 }
 
@@ -290,20 +394,31 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
-
 	if (!frameSync->isPlaying())
 		return false;
 
 	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
+
+	// Show the newest frame that's due, any older ones are dropped.
+	Frame *next = nullptr;
+	while (!frameQueue.empty() && frameQueue.front().time <= presentPosition)
+	{
+		if (next != nullptr)
+		{
+			releaseFrame(next);
+			droppedFrames++;
+		}
+
+		next = frameQueue.front().frame;
+		frontTime = frameQueue.front().time;
+		frameQueue.pop_front();
+	}
+
+	if (next == nullptr)
 		return false;
-	frameReady = false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	releaseFrame(frontBuffer);
+	frontBuffer = next;
 
 	return true;
 }
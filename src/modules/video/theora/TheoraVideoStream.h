@@ -29,6 +29,10 @@
 #include "thread/threads.h"
 #include "OggDemuxer.h"
 
+// C++
+#include <deque>
+#include <vector>
+
 // OGG/Theora
 #include <ogg/ogg.h>
 #include <theora/codec.h>
@@ -59,9 +63,23 @@ class TheoraVideoStream : public love::video::VideoStream
 
 	bool isPlaying() const;
 
+	void setFrameQueueSize(int size);
+	int getFrameQueueSize() const;
+	int getQueuedFrameCount() const;
+	int getDroppedFrameCount() const;
+
 	void threadedFillBackBuffer(double dt);
 
+	static const int DEFAULT_FRAME_QUEUE_SIZE = 4;
+
 private:
+
+	struct QueuedFrame
+	{
+		Frame *frame;
+		double time;
+	};
+
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -72,20 +90,32 @@ class TheoraVideoStream : public love::video::VideoStream
 	th_dec_ctx *decoder;
 
 	Frame *frontBuffer;
-	Frame *backBuffer;
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
+	// Decoded frames waiting to be shown, and the frames they can reuse.
+	// Access is guarded by bufferMutex.
+	std::deque<QueuedFrame> frameQueue;
+	std::vector<Frame *> freeFrames;
+	int frameCount;
+	int frameQueueSize;
+	int droppedFrames;
+	double frontTime;
+	double presentPosition;
+
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
 	double lastFrame;
 	double nextFrame;
 
 	void parseHeader();
 	void seekDecoder(double target);
+	Frame *newFrame() const;
+	void copyPlanes(const th_ycbcr_buffer &bufferinfo, Frame *frame) const;
+	void releaseFrame(Frame *frame);
+	void clearFrameQueue();
 }; // TheoraVideoStream
 
 } // theora
@@ -19,11 +19,13 @@
  **/
 
 // STL
+#include <algorithm>
 #include <vector>
 
 // LOVE
 #include "Video.h"
 #include "common/delay.h"
+#include "thread/parallel.h"
 #include "timer/Timer.h"
 
 namespace love
@@ -88,38 +90,47 @@ void Worker::stop()
 void Worker::threadFunction()
 {
 	double lastFrame = love::timer::Timer::getTime();
+	std::vector<StrongRef<TheoraVideoStream>> active;
 
 	while (true)
 	{
 		love::sleep(2);
 
-		love::thread::Lock l(mutex);
-
-		while (!stopping && streams.empty())
 		{
-			cond->wait(mutex);
-			lastFrame = love::timer::Timer::getTime();
-		}
+			love::thread::Lock l(mutex);
 
-		if (stopping)
-			return;
+			while (!stopping && streams.empty())
+			{
+				cond->wait(mutex);
+				lastFrame = love::timer::Timer::getTime();
+			}
+
+			if (stopping)
+				return;
+
+			// Drop the streams we're the only ones left referencing
+			auto unused = [](const StrongRef<TheoraVideoStream> &stream)
+			{
+				return stream->getReferenceCount() == 1;
+			};
+
+			streams.erase(std::remove_if(streams.begin(), streams.end(), unused), streams.end());
+			active = streams;
+		}
 
 		double curFrame = love::timer::Timer::getTime();
 		double dt = curFrame-lastFrame;
 		lastFrame = curFrame;
 
-		for (auto it = streams.begin(); it != streams.end(); ++it)
+		// Streams don't share any state, so they're decoded in parallel and
+		// without holding the lock, which addStream would otherwise wait on.
+		love::thread::parallelFor((int) active.size(), 1, [&](int begin, int end)
 		{
-			TheoraVideoStream *stream = *it;
-			if (stream->getReferenceCount() == 1)
-			{
-				// We're the only ones left
-				streams.erase(it);
-				break;
-			}
+			for (int i = begin; i < end; i++)
+				active[i]->threadedFillBackBuffer(dt);
+		});
 
-			stream->threadedFillBackBuffer(dt);
-		}
+		active.clear();
 	}
 }
 
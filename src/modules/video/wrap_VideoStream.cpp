@@ -109,6 +109,35 @@ int w_VideoStream_isPlaying(lua_State *L)
 	return 1;
 }
 
+int w_VideoStream_setFrameQueueSize(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	int size = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&]() { stream->setFrameQueueSize(size); });
+	return 0;
+}
+
+int w_VideoStream_getFrameQueueSize(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getFrameQueueSize());
+	return 1;
+}
+
+int w_VideoStream_getQueuedFrameCount(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getQueuedFrameCount());
+	return 1;
+}
+
+int w_VideoStream_getDroppedFrameCount(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getDroppedFrameCount());
+	return 1;
+}
+
 static const luaL_Reg videostream_functions[] =
 {
 	{ "setSync", w_VideoStream_setSync },
@@ -119,6 +148,10 @@ static const luaL_Reg videostream_functions[] =
 	{ "rewind", w_VideoStream_rewind },
 	{ "tell", w_VideoStream_tell },
 	{ "isPlaying", w_VideoStream_isPlaying },
+	{ "setFrameQueueSize", w_VideoStream_setFrameQueueSize },
+	{ "getFrameQueueSize", w_VideoStream_getFrameQueueSize },
+	{ "getQueuedFrameCount", w_VideoStream_getQueuedFrameCount },
+	{ "getDroppedFrameCount", w_VideoStream_getDroppedFrameCount },
 	{ 0, 0 }
 };
 
@@ -258,6 +258,9 @@ function love.createhandlers()
 		threaderror = function (t, err)
 			if love.threaderror then return love.threaderror(t, err) end
 		end,
+		filesystemread = function (request, path, data, err, last)
+			if love.filesystem then return love.filesystem._dispatchRead(request, path, data, err, last) end
+		end,
 		resize = function (w, h)
 			if love.resize then return love.resize(w, h) end
 		end,
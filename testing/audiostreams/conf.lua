@@ -0,0 +1,5 @@
+function love.conf(t)
+	t.identity = "love-testing-audiostreams"
+	t.window = false
+	t.modules.graphics = false
+end
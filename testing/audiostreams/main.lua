@@ -0,0 +1,88 @@
+-- Plays 64 streaming Sources at once and measures how long the main thread
+-- spends in Source calls (which need the audio pool's lock), and how far the
+-- streams fall behind real time.
+--
+-- By default every stream plays a generated WAV file. Pass the path of a
+-- file in the save directory or the game's source to stream it instead,
+-- e.g. an Ogg Vorbis file for a heavier decoder:
+--
+--	love testing/audiostreams music.ogg
+
+local STREAMS = 64
+local DURATION = 10 -- Seconds to measure for.
+
+local function writeTestFile(filename, seconds)
+	local rate, channels = 44100, 2
+	local samples = rate * seconds
+	local parts = {}
+
+	for i = 0, samples - 1 do
+		local v = math.floor(math.sin(i * 2 * math.pi * 440 / rate) * 8000)
+		parts[#parts + 1] = love.data.pack("string", "<i2i2", v, v)
+	end
+
+	local pcm = table.concat(parts)
+	local header = love.data.pack("string", "<c4I4c4c4I4I2I2I4I4I2I2c4I4",
+		"RIFF", 36 + #pcm, "WAVE", "fmt ", 16, 1, channels, rate,
+		rate * channels * 2, channels * 2, 16, "data", #pcm)
+
+	love.filesystem.write(filename, header .. pcm)
+end
+
+local sources = {}
+local starttime
+local frames = 0
+local calltime = 0
+local maxcalltime = 0
+local maxlag = 0
+
+function love.load(args)
+	local filename = args[1]
+
+	if filename == nil then
+		filename = "stream.wav"
+		writeTestFile(filename, DURATION + 5)
+	end
+
+	for i = 1, STREAMS do
+		local source = love.audio.newSource(filename, "stream")
+		source:setVolume(1 / STREAMS)
+		sources[i] = source
+	end
+
+	love.audio.play(sources)
+	starttime = love.timer.getTime()
+
+	print(string.format("%d streams of %s for %d seconds", STREAMS, filename, DURATION))
+end
+
+function love.update(dt)
+	local elapsed = love.timer.getTime() - starttime
+
+	local start = love.timer.getTime()
+	for i, source in ipairs(sources) do
+		source:setVolume(1 / STREAMS)
+		maxlag = math.max(maxlag, elapsed - source:tell())
+	end
+	local t = love.timer.getTime() - start
+
+	calltime = calltime + t
+	maxcalltime = math.max(maxcalltime, t)
+	frames = frames + 1
+
+	if elapsed >= DURATION then
+		local playing = 0
+		for i, source in ipairs(sources) do
+			if source:isPlaying() then
+				playing = playing + 1
+			end
+		end
+
+		print(string.format("Source calls per frame: %.3f ms average, %.3f ms worst",
+			calltime * 1000 / frames, maxcalltime * 1000))
+		print(string.format("Largest lag behind real time: %.1f ms", maxlag * 1000))
+		print(string.format("Still playing: %d of %d", playing, STREAMS))
+
+		love.event.quit()
+	end
+end
@@ -0,0 +1,55 @@
+-- Measures Channel throughput when several threads push to one Channel while
+-- the main thread pops from it, with the default (mutex) Channels and with
+-- lock-free ones.
+
+local PRODUCERS = 8
+local VALUES_PER_PRODUCER = 200000
+
+local producer = [[
+local channel, count = ...
+for i = 1, count do
+	channel:push(i)
+end
+]]
+
+local function run(channel)
+	local threads = {}
+	local start = love.timer.getTime()
+
+	for i = 1, PRODUCERS do
+		threads[i] = love.thread.newThread(producer)
+		threads[i]:start(channel, VALUES_PER_PRODUCER)
+	end
+
+	local total = PRODUCERS * VALUES_PER_PRODUCER
+	for i = 1, total do
+		channel:demand()
+	end
+
+	local elapsed = love.timer.getTime() - start
+
+	for i, t in ipairs(threads) do
+		t:wait()
+		local err = t:getError()
+		if err then error(err) end
+	end
+
+	return elapsed, total
+end
+
+function love.load()
+	local modes = {
+		{"mutex", love.thread.newChannel()},
+		{"lock-free (capacity 1024)", love.thread.newChannel{lockfree = true, capacity = 1024}},
+		{"lock-free (capacity 65536)", love.thread.newChannel{lockfree = true, capacity = 65536}},
+	}
+
+	print(string.format("%d producers, %d values each", PRODUCERS, VALUES_PER_PRODUCER))
+
+	for _, mode in ipairs(modes) do
+		local elapsed, total = run(mode[2])
+		print(string.format("%-28s %8.1f ms  %10.0f values/s", mode[1], elapsed * 1000, total / elapsed))
+	end
+
+	love.event.quit()
+end
@@ -0,0 +1,128 @@
+-- Checks love.data's CompressStream and DecompressStream: round trips in
+-- every format, compatibility with love.data.decompress, concatenated gzip
+-- members and error handling. Exits with 1 if anything fails.
+
+local failures = 0
+
+local function check(name, ok, detail)
+	print(string.format("%-4s %s%s", ok and "ok" or "FAIL", name, detail and ("  (" .. detail .. ")") or ""))
+	if not ok then
+		failures = failures + 1
+	end
+end
+
+local function makeInput(size)
+	love.math.setRandomSeed(1)
+	local chars = {}
+	for i = 1, size do
+		local c = 97 + love.math.random(0, 3)
+		if i % 7 == 0 then
+			c = c + love.math.random(0, 19)
+		end
+		chars[i] = string.char(c)
+	end
+	return table.concat(chars)
+end
+
+-- Writes the input in uneven pieces, with a flush now and then.
+local function compress(format, level, input)
+	local stream = love.data.newCompressStream(format, level)
+	local out = {}
+	local pos, step, writes = 1, 1, 0
+
+	while pos <= #input do
+		out[#out + 1] = stream:write(input:sub(pos, pos + step - 1))
+		pos = pos + step
+		step = step * 3 % 9973 + 1
+		writes = writes + 1
+		if writes % 11 == 0 then
+			out[#out + 1] = stream:flush()
+		end
+	end
+
+	out[#out + 1] = stream:finish()
+	return table.concat(out)
+end
+
+local function decompress(format, compressed, step)
+	local stream = love.data.newDecompressStream(format)
+	local out = {}
+
+	for pos = 1, #compressed, step do
+		out[#out + 1] = stream:write(compressed:sub(pos, pos + step - 1))
+	end
+
+	stream:finish()
+	return table.concat(out)
+end
+
+local function testRoundTrips(input)
+	for _, format in ipairs({"lz4", "zlib", "gzip", "deflate"}) do
+		for _, level in ipairs({-1, 1, 9}) do
+			local compressed = compress(format, level, input)
+			local name = string.format("%s level %d", format, level)
+			local detail = string.format("%d -> %d bytes", #input, #compressed)
+
+			check(name .. " round trip", decompress(format, compressed, 4093) == input, detail)
+
+			-- LZ4 streams are split into blocks, so only zlib formats can be
+			-- read by love.data.decompress.
+			if format ~= "lz4" then
+				check(name .. " love.data.decompress", love.data.decompress("string", format, compressed) == input)
+			end
+		end
+
+		local small = input:sub(1, 20000)
+		check(format .. " byte at a time", decompress(format, compress(format, -1, small), 1) == small)
+	end
+end
+
+local function testLZ4Levels(input)
+	local sizes = {}
+	for _, level in ipairs({9, 12}) do
+		local compressed = compress("lz4", level, input)
+		sizes[level] = #compressed
+		check("lz4 level " .. level .. " round trip", decompress("lz4", compressed, #compressed) == input)
+	end
+	check("lz4 level 12 is smaller than level 9", sizes[12] < sizes[9], sizes[9] .. " vs " .. sizes[12])
+end
+
+local function testGzipMembers(input)
+	local first = input:sub(1, 50000)
+	local second = "a second gzip member"
+	local joined = compress("gzip", 6, first) .. compress("gzip", 6, second)
+
+	for _, step in ipairs({1, 7, 4096, #joined}) do
+		check("gzip members, " .. step .. " bytes per write", decompress("gzip", joined, step) == first .. second)
+	end
+end
+
+local function testErrors(input)
+	for _, format in ipairs({"zlib", "deflate"}) do
+		local compressed = compress(format, 6, input:sub(1, 10000))
+		local ok = pcall(decompress, format, compressed .. "!", #compressed + 1)
+		check(format .. " trailing input is an error", not ok)
+	end
+
+	for _, format in ipairs({"lz4", "zlib", "gzip", "deflate"}) do
+		local compressed = compress(format, 6, input:sub(1, 10000))
+		local ok = pcall(decompress, format, compressed:sub(1, -2), 1024)
+		check(format .. " truncated stream is an error", not ok)
+	end
+
+	local stream = love.data.newCompressStream("zlib")
+	stream:finish()
+	check("write after finish is an error", not pcall(stream.write, stream, "x"))
+end
+
+function love.load()
+	local input = makeInput(1000000)
+
+	testRoundTrips(input)
+	testLZ4Levels(input:sub(1, 400000))
+	testGzipMembers(input)
+	testErrors(input)
+
+	print(failures == 0 and "all passed" or (failures .. " failed"))
+	love.event.quit(failures == 0 and 0 or 1)
+end
@@ -0,0 +1,75 @@
+-- Measures World:update with 1k, 10k and 50k bodies at several thread counts.
+-- The bodies are stacked in small piles, so each pile is its own island.
+
+local BODY_COUNTS = {1000, 10000, 50000}
+local PILE_HEIGHT = 5
+local SIZE = 16
+local SETTLE_STEPS = 60
+local STEPS = 120
+
+local function newWorld(bodycount)
+	-- Sleeping islands aren't solved at all, so sleeping is disabled.
+	local world = love.physics.newWorld(0, 9.81 * 64, false)
+
+	local piles = math.ceil(bodycount / PILE_HEIGHT)
+	local width = piles * SIZE * 2
+
+	local ground = love.physics.newBody(world, width / 2, SIZE / 2, "static")
+	love.physics.newFixture(ground, love.physics.newRectangleShape(width, SIZE))
+
+	local shape = love.physics.newRectangleShape(SIZE, SIZE)
+
+	for i = 0, bodycount - 1 do
+		local pile = math.floor(i / PILE_HEIGHT)
+		local level = i % PILE_HEIGHT
+		local x = pile * SIZE * 2 + SIZE
+		local y = -(level + 0.5) * SIZE - level * 0.5
+
+		local body = love.physics.newBody(world, x, y, "dynamic")
+		love.physics.newFixture(body, shape, 1)
+	end
+
+	return world
+end
+
+local function measure(bodycount, threads)
+	local world = newWorld(bodycount)
+	world:setThreadCount(threads)
+
+	for i = 1, SETTLE_STEPS do
+		world:update(1 / 60)
+	end
+
+	local start = love.timer.getTime()
+	for i = 1, STEPS do
+		world:update(1 / 60)
+	end
+	local elapsed = love.timer.getTime() - start
+
+	world:destroy()
+	return elapsed * 1000 / STEPS
+end
+
+function love.load()
+	local threadcounts = {1, 2, 4}
+	local cores = love.system.getProcessorCount()
+	if cores > 4 then
+		table.insert(threadcounts, cores)
+	end
+
+	print(string.format("%d steps per measurement, %d cores", STEPS, cores))
+
+	for _, bodycount in ipairs(BODY_COUNTS) do
+		local serial = nil
+
+		for _, threads in ipairs(threadcounts) do
+			local ms = measure(bodycount, threads)
+			serial = serial or ms
+
+			print(string.format("%6d bodies  %2d threads  %8.3f ms/step  %5.2fx",
+				bodycount, threads, ms, serial / ms))
+		end
+	end
+
+	love.event.quit()
+end